@@ -0,0 +1,346 @@
+/*
+===================================== BIG INTEGER ======================================
+
+Exact factorials and Fibonacci numbers for large n.
+
+The commented factorial() and the fib() in Recursion.cpp return int, which overflows
+at 13! and fib(46). BigInt below is an arbitrary-precision unsigned integer:
+
+- Representation
+    vector<uint32_t> of "limbs", least significant first, base 2^32. Zero has no limbs.
+    32-bit limbs let one limb * limb product fit in a uint64_t.
+
+- Multiplication
+    Schoolbook O(n*m) for short operands. Above KARATSUBA_THRESHOLD limbs, Karatsuba:
+        a = a1*B + a0, b = b1*B + b0
+        a*b = z2*B^2 + ((a0+a1)(b0+b1) - z2 - z0)*B + z0,  z2 = a1*b1, z0 = a0*b0
+    Three half-size products instead of four -> O(n^1.585).
+    Very unbalanced operands are cut into chunks of the shorter length first.
+
+- factorial(n): product tree
+    Multiplying 1*2*3*...*n left to right keeps multiplying a huge number by a tiny one,
+    so Karatsuba never helps. Instead:
+      1. strip the factors of 2 from every i (added back at the end as one shift),
+      2. pack the odd parts into limb-sized leaves,
+      3. multiply neighbours pairwise, level by level (a balanced "product tree"),
+    so the expensive multiplications are between equally sized numbers.
+
+- fibonacci(n): fast doubling (see FastFibonacci.cpp)
+    F(2k) = F(k) * (2F(k+1) - F(k)),  F(2k+1) = F(k)^2 + F(k+1)^2
+    Keeps Recursion.cpp's convention fib(0) = fib(1) = 1, i.e. fibonacci(n) = F(n+1).
+
+toString() uses repeated division by 10^9 (quadratic), which is fine for printing
+moderately large values; the demo prints only sizes and leading digits for the huge ones.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+class BigInt {
+public:
+    using Limb = uint32_t;
+    static constexpr size_t KARATSUBA_THRESHOLD = 48;
+
+private:
+    vector<Limb> d; // little-endian limbs, no leading (high) zero limbs
+
+    void trim() {
+        while (!d.empty() && d.back() == 0) d.pop_back();
+    }
+
+    /* r[shift...] += x */
+    static void addAt(vector<Limb>& r, const Limb* x, size_t nx, size_t shift) {
+        if (r.size() < shift + nx + 1) r.resize(shift + nx + 1, 0);
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < nx; i++) {
+            uint64_t s = static_cast<uint64_t>(r[shift + i]) + x[i] + carry;
+            r[shift + i] = static_cast<Limb>(s);
+            carry = s >> 32;
+        }
+        for (size_t j = shift + i; carry; j++) {
+            if (j == r.size()) r.push_back(0);
+            uint64_t s = static_cast<uint64_t>(r[j]) + carry;
+            r[j] = static_cast<Limb>(s);
+            carry = s >> 32;
+        }
+    }
+
+    /* r -= x, requires r >= x */
+    static void subInPlace(vector<Limb>& r, const vector<Limb>& x) {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < r.size(); i++) {
+            int64_t s = static_cast<int64_t>(r[i]) - (i < x.size() ? x[i] : 0) - borrow;
+            borrow = s < 0;
+            r[i] = static_cast<Limb>(s + (borrow << 32));
+            if (i >= x.size() && !borrow) break;
+        }
+    }
+
+    static vector<Limb> addVec(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        vector<Limb> r(a, a + na);
+        addAt(r, b, nb, 0);
+        while (!r.empty() && r.back() == 0) r.pop_back();
+        return r;
+    }
+
+    static vector<Limb> schoolbook(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        vector<Limb> r(na + nb, 0);
+        for (size_t i = 0; i < na; i++) {
+            uint64_t carry = 0, ai = a[i];
+            if (ai == 0) continue;
+            for (size_t j = 0; j < nb; j++) {
+                uint64_t t = ai * b[j] + r[i + j] + carry;
+                r[i + j] = static_cast<Limb>(t);
+                carry = t >> 32;
+            }
+            r[i + nb] = static_cast<Limb>(carry);
+        }
+        return r;
+    }
+
+    static vector<Limb> multiply(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        while (na > 0 && a[na - 1] == 0) na--;
+        while (nb > 0 && b[nb - 1] == 0) nb--;
+        if (na == 0 || nb == 0) return {};
+        if (na < nb) {
+            swap(a, b);
+            swap(na, nb);
+        }
+        if (nb < KARATSUBA_THRESHOLD) return schoolbook(a, na, b, nb);
+
+        // Unbalanced: multiply nb-sized chunks of a by b and add them up
+        if (na >= 2 * nb) {
+            vector<Limb> r;
+            for (size_t off = 0; off < na; off += nb) {
+                vector<Limb> part = multiply(a + off, min(nb, na - off), b, nb);
+                addAt(r, part.data(), part.size(), off);
+            }
+            return r;
+        }
+
+        size_t m = na / 2; // nb > m here, so both operands have a high half
+        vector<Limb> z0 = multiply(a, m, b, m);
+        vector<Limb> z2 = multiply(a + m, na - m, b + m, nb - m);
+        vector<Limb> sa = addVec(a, m, a + m, na - m);
+        vector<Limb> sb = addVec(b, m, b + m, nb - m);
+        vector<Limb> z1 = multiply(sa.data(), sa.size(), sb.data(), sb.size());
+        while (!z1.empty() && z1.back() == 0) z1.pop_back();
+        subInPlace(z1, z0);
+        subInPlace(z1, z2);
+
+        vector<Limb> r(na + nb + 1, 0);
+        addAt(r, z0.data(), z0.size(), 0);
+        addAt(r, z1.data(), z1.size(), m);
+        addAt(r, z2.data(), z2.size(), 2 * m);
+        return r;
+    }
+
+public:
+    BigInt() = default;
+    BigInt(uint64_t v) {
+        while (v) {
+            d.push_back(static_cast<Limb>(v));
+            v >>= 32;
+        }
+    }
+
+    bool isZero() const { return d.empty(); }
+    size_t limbs() const { return d.size(); }
+
+    size_t bitLength() const {
+        if (d.empty()) return 0;
+        return 32 * (d.size() - 1) + (32 - __builtin_clz(d.back()));
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) { return a.d == b.d; }
+    friend bool operator<(const BigInt& a, const BigInt& b) {
+        if (a.d.size() != b.d.size()) return a.d.size() < b.d.size();
+        return lexicographical_compare(a.d.rbegin(), a.d.rend(), b.d.rbegin(), b.d.rend());
+    }
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b) {
+        BigInt r;
+        r.d = addVec(a.d.data(), a.d.size(), b.d.data(), b.d.size());
+        return r;
+    }
+
+    /* Unsigned subtraction: requires a >= b */
+    friend BigInt operator-(const BigInt& a, const BigInt& b) {
+        BigInt r = a;
+        subInPlace(r.d, b.d);
+        r.trim();
+        return r;
+    }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        BigInt r;
+        r.d = multiply(a.d.data(), a.d.size(), b.d.data(), b.d.size());
+        r.trim();
+        return r;
+    }
+
+    BigInt& operator*=(Limb m) {
+        uint64_t carry = 0;
+        for (Limb& x : d) {
+            uint64_t t = static_cast<uint64_t>(x) * m + carry;
+            x = static_cast<Limb>(t);
+            carry = t >> 32;
+        }
+        if (carry) d.push_back(static_cast<Limb>(carry));
+        if (m == 0) d.clear();
+        return *this;
+    }
+
+    BigInt operator<<(size_t bits) const {
+        if (d.empty()) return *this;
+        BigInt r;
+        size_t limbShift = bits / 32, bitShift = bits % 32;
+        r.d.assign(limbShift, 0);
+        Limb carry = 0;
+        for (Limb x : d) {
+            r.d.push_back(bitShift ? (x << bitShift) | carry : x);
+            carry = bitShift ? x >> (32 - bitShift) : 0;
+        }
+        if (carry) r.d.push_back(carry);
+        return r;
+    }
+
+    /* Decimal string by repeated division by 10^9 (O(n^2)) */
+    string toString() const {
+        if (d.empty()) return "0";
+        vector<Limb> cur = d;
+        vector<Limb> chunks; // base 10^9 digits, least significant first
+        while (!cur.empty()) {
+            uint64_t rem = 0;
+            for (size_t i = cur.size(); i-- > 0;) {
+                uint64_t v = (rem << 32) | cur[i];
+                cur[i] = static_cast<Limb>(v / 1000000000);
+                rem = v % 1000000000;
+            }
+            chunks.push_back(static_cast<Limb>(rem));
+            while (!cur.empty() && cur.back() == 0) cur.pop_back();
+        }
+        string s = to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            string part = to_string(chunks[i]);
+            s += string(9 - part.size(), '0') + part;
+        }
+        return s;
+    }
+
+    /* log10 from the top 64 bits; good enough for digit counts and leading digits */
+    double log10() const {
+        if (d.empty()) return -INFINITY;
+        size_t n = d.size();
+        double top = d[n - 1] * 4294967296.0 + (n >= 2 ? d[n - 2] : 0);
+        return std::log10(top) + (n >= 2 ? (n - 2) * 32 * std::log10(2.0) : -32 * std::log10(2.0));
+    }
+};
+
+/* Product of a list of BigInts with a balanced product tree */
+BigInt productTree(vector<BigInt> level) {
+    if (level.empty()) return BigInt(1);
+    while (level.size() > 1) {
+        vector<BigInt> next;
+        next.reserve((level.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < level.size(); i += 2) next.push_back(level[i] * level[i + 1]);
+        if (level.size() % 2) next.push_back(move(level.back()));
+        level = move(next);
+    }
+    return level[0];
+}
+
+BigInt factorial(uint32_t n) {
+    size_t twos = 0;
+    vector<BigInt> leaves;
+    uint64_t leaf = 1;
+    for (uint32_t i = 2; i <= n; i++) {
+        uint32_t odd = i;
+        int z = __builtin_ctz(odd);
+        twos += z;
+        odd >>= z;
+        if (leaf * odd > UINT32_MAX) {
+            leaves.emplace_back(leaf);
+            leaf = 1;
+        }
+        leaf *= odd;
+    }
+    leaves.emplace_back(leaf);
+    return productTree(move(leaves)) << twos;
+}
+
+/* fib as in Recursion.cpp: fibonacci(n) = F(n+1) */
+BigInt fibonacci(uint64_t n) {
+    uint64_t k = n + 1;
+    BigInt a = 0, b = 1; // F(0), F(1)
+    for (int bit = 63 - __builtin_clzll(k | 1); bit >= 0; bit--) {
+        BigInt c = a * ((b << 1) - a); // F(2j)
+        BigInt d = a * a + b * b;      // F(2j+1)
+        if ((k >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = move(c);
+            b = move(d);
+        }
+    }
+    return a;
+}
+
+/* Straightforward reference for checking: 1 * 2 * ... * n */
+BigInt factorialNaive(uint32_t n) {
+    BigInt r = 1;
+    for (uint32_t i = 2; i <= n; i++) r *= i;
+    return r;
+}
+
+void describe(const string& label, const BigInt& x, double ms) {
+    double lg = x.log10();
+    long long digits = static_cast<long long>(floor(lg)) + 1;
+    double mantissa = pow(10.0, lg - floor(lg));
+    cout << label << ": " << digits << " digits (~" << mantissa << "e" << digits - 1 << "), "
+         << x.bitLength() << " bits, computed in " << ms << " ms\n";
+}
+
+int main() {
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+
+    cout << "25! = " << factorial(25).toString() << "\n";
+    cout << "fib(100) = " << fibonacci(100).toString() << "\n";
+    cout << "factorial(3000) matches the naive product: "
+         << (factorial(3000) == factorialNaive(3000) ? "yes" : "NO") << "\n";
+    // F(n+1) + F(n+2) == F(n+3)
+    cout << "fibonacci(5000) + fibonacci(5001) == fibonacci(5002): "
+         << (fibonacci(5000) + fibonacci(5001) == fibonacci(5002) ? "yes" : "NO") << "\n\n";
+
+    for (uint32_t n : {10000u, 100000u}) {
+        auto t0 = Clock::now();
+        BigInt f = factorial(n);
+        auto t1 = Clock::now();
+        describe(to_string(n) + "!", f, ms(t1 - t0));
+    }
+    {
+        auto t0 = Clock::now();
+        BigInt f = factorialNaive(100000);
+        auto t1 = Clock::now();
+        describe("100000! (naive loop)", f, ms(t1 - t0));
+    }
+    for (uint64_t n : {100000ull, 1000000ull}) {
+        auto t0 = Clock::now();
+        BigInt f = fibonacci(n);
+        auto t1 = Clock::now();
+        describe("fib(" + to_string(n) + ")", f, ms(t1 - t0));
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+================================ BULK PRIORITY QUEUE ===================================
+
+Bulk loading and batched push/pop for the Item min-heap.
+
+Pushing n Items one at a time through priority_queue::push costs O(n log n), and each
+sift-up wanders through the heap. When Items arrive in bursts we can do better:
+
+- Bulk construction (Floyd's heapify)
+    Append everything, then sift down every internal node from the last one to the
+    root. Most nodes are near the bottom and sift only a level or two, so the total
+    work is O(n). std::make_heap does exactly this.
+
+- push_range(first, last)
+    Appending k items to a heap of n and sifting each up costs ~k log n.
+    A full re-heapify costs ~2(n + k). We pick whichever is cheaper.
+
+- pop_n(k)
+    Returns the k most important Items in order. Instead of k separate pops (each a
+    full sift-down hopping across the whole array), we do one partial sort:
+    nth_element selects the top k in O(n), sort orders just those k, and the rest
+    is re-heapified in O(n).
+    (For k much smaller than n, plain pops are cheaper; pop_n switches over.)
+
+BulkPriorityQueue keeps the usual push / top / pop / empty / size interface and uses
+CompareItem exactly the way priority_queue does.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+template <class T, class Compare>
+class BulkPriorityQueue {
+    vector<T> heap;
+    Compare comp;
+
+public:
+    BulkPriorityQueue() = default;
+
+    /* Bulk construction: O(n) Floyd heapify */
+    explicit BulkPriorityQueue(vector<T> items, Compare c = Compare())
+        : heap(move(items)), comp(c) {
+        make_heap(heap.begin(), heap.end(), comp);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    const T& top() const { return heap.front(); }
+
+    void push(T item) {
+        heap.push_back(move(item));
+        push_heap(heap.begin(), heap.end(), comp);
+    }
+
+    void pop() {
+        pop_heap(heap.begin(), heap.end(), comp);
+        heap.pop_back();
+    }
+
+    /* Append a whole batch; choose per-item sift-up or one full re-heapify */
+    template <class It>
+    void push_range(It first, It last) {
+        size_t oldSize = heap.size();
+        heap.insert(heap.end(), make_move_iterator(first), make_move_iterator(last));
+        size_t k = heap.size() - oldSize;
+        if (k == 0) return;
+
+        double siftCost = k * log2(static_cast<double>(heap.size()) + 1);
+        double heapifyCost = 2.0 * heap.size();
+        if (heapifyCost < siftCost) {
+            make_heap(heap.begin(), heap.end(), comp);
+        } else {
+            for (size_t i = oldSize + 1; i <= heap.size(); i++)
+                push_heap(heap.begin(), heap.begin() + i, comp);
+        }
+    }
+
+    /* Remove and return the k most important items, most important first */
+    vector<T> pop_n(size_t k) {
+        k = min(k, heap.size());
+        vector<T> out;
+        out.reserve(k);
+
+        double popCost = k * 2 * log2(static_cast<double>(heap.size()) + 1);
+        double sortCost = heap.size() + k * log2(static_cast<double>(k) + 1) + 2.0 * (heap.size() - k);
+        if (popCost <= sortCost) {
+            for (size_t i = 0; i < k; i++) {
+                pop_heap(heap.begin(), heap.end(), comp);
+                out.push_back(move(heap.back()));
+                heap.pop_back();
+            }
+            return out;
+        }
+
+        // Under comp the winners are the "largest" elements: select them into the tail,
+        // sort just that tail, then re-heapify what is left.
+        size_t rest = heap.size() - k;
+        nth_element(heap.begin(), heap.begin() + rest, heap.end(), comp);
+        sort(heap.begin() + rest, heap.end(), comp);
+        for (size_t i = heap.size(); i > rest; i--) out.push_back(move(heap[i - 1]));
+        heap.erase(heap.begin() + rest, heap.end());
+        make_heap(heap.begin(), heap.end(), comp);
+        return out;
+    }
+};
+
+/* DEMO */
+void basicDemo() {
+    vector<Item> burst = {Item(3, "Whey Protein"), Item(1, "Eggs"), Item(5, "Dumbbells")};
+    BulkPriorityQueue<Item, CompareItem> itemQueue(move(burst));
+
+    vector<Item> more = {Item(2, "Cables"), Item(4, "Bench")};
+    itemQueue.push_range(more.begin(), more.end());
+
+    cout << "Top 3 items:\n";
+    for (const Item& i : itemQueue.pop_n(3))
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+
+    cout << "Remaining:\n";
+    while (!itemQueue.empty()) {
+        cout << "- " << itemQueue.top().description << " (Priority: " << itemQueue.top().priority << ")\n";
+        itemQueue.pop();
+    }
+}
+
+/* BENCHMARK: load a burst of n items, then drain in batches of k */
+void benchmark(size_t n, size_t k) {
+    mt19937 rng(3);
+    uniform_int_distribution<int> dist(0, 1 << 30);
+    vector<Item> burst;
+    burst.reserve(n);
+    for (size_t i = 0; i < n; i++) burst.emplace_back(dist(rng), "task");
+
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+    long long c1 = 0, c2 = 0;
+
+    vector<Item> copy1 = burst;
+    auto t0 = Clock::now();
+    priority_queue<Item, vector<Item>, CompareItem> pq;
+    for (Item& it : copy1) pq.push(move(it));
+    auto t1 = Clock::now();
+    while (!pq.empty()) {
+        for (size_t i = 0; i < k && !pq.empty(); i++) {
+            c1 += pq.top().priority;
+            pq.pop();
+        }
+    }
+    auto t2 = Clock::now();
+
+    vector<Item> copy2 = burst;
+    auto t3 = Clock::now();
+    BulkPriorityQueue<Item, CompareItem> bulk(move(copy2));
+    auto t4 = Clock::now();
+    while (!bulk.empty())
+        for (const Item& it : bulk.pop_n(k)) c2 += it.priority;
+    auto t5 = Clock::now();
+
+    cout << "\nBenchmark (" << n << " items, drained in batches of " << k << "):\n"
+         << "  priority_queue: load " << ms(t1 - t0) << " ms, drain " << ms(t2 - t1) << " ms\n"
+         << "  bulk heap:      load " << ms(t4 - t3) << " ms, drain " << ms(t5 - t4) << " ms\n"
+         << "  checksums match: " << (c1 == c2 ? "yes" : "NO") << endl;
+}
+
+int main() {
+    basicDemo();
+    benchmark(2000000, 100);
+    benchmark(2000000, 500000);
+    return 0;
+}
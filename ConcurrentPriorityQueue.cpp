@@ -0,0 +1,253 @@
+/*
+============================ CONCURRENT PRIORITY QUEUE =================================
+
+Scheduling Items from many threads.
+
+The obvious approach
+  Wrap priority_queue<Item, vector<Item>, CompareItem> in a mutex. Correct, but every
+  push and pop from every thread serializes on one lock and one cache line.
+
+MultiQueue (Rihani, Sanders, Dementiev)
+  - Keep c * threads ordinary binary heaps, each with its own lock.
+  - push: lock a random heap and push there.
+  - pop:  look at the tops of k random heaps (k = 2 by default, "power of two choices"),
+          lock the one with the smallest priority and pop it.
+  Contention almost disappears because threads rarely pick the same heap.
+  The price is relaxed ordering: a pop may return an Item that is not the global
+  minimum. In expectation its rank error is O(c * threads), independent of size.
+
+Strictness knobs
+  queuesPerThread (c): more heaps = less contention, more rank error.
+  choices (k):         more samples per pop = better quality, more work.
+  StrictQueue below is the mutex-wrapped baseline (rank error always 0).
+
+The benchmark sweeps thread counts and reports throughput; the quality test
+measures how far pops deviate from exact order (rank error).
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* Cheap per-thread random numbers (xorshift64) */
+static uint64_t nextRandom() {
+    thread_local uint64_t state =
+        0x9E3779B97F4A7C15ull ^ hash<thread::id>()(this_thread::get_id());
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/* STRICT BASELINE: one heap, one lock */
+class StrictQueue {
+    priority_queue<Item, vector<Item>, CompareItem> heap;
+    mutex m;
+
+public:
+    void push(Item item) {
+        lock_guard<mutex> lock(m);
+        heap.push(move(item));
+    }
+
+    bool tryPop(Item& out) {
+        lock_guard<mutex> lock(m);
+        if (heap.empty()) return false;
+        out = heap.top();
+        heap.pop();
+        return true;
+    }
+};
+
+/* RELAXED: MultiQueue */
+class MultiQueue {
+    struct alignas(64) Shard {
+        mutex m;
+        priority_queue<Item, vector<Item>, CompareItem> heap;
+        atomic<int> topPriority{INT_MAX}; // lock-free peek; INT_MAX means empty
+
+        void publishTop() {
+            topPriority.store(heap.empty() ? INT_MAX : heap.top().priority, memory_order_relaxed);
+        }
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    int choices;
+
+    Shard& randomShard() { return *shards[nextRandom() % shards.size()]; }
+
+public:
+    MultiQueue(int threads, int queuesPerThread = 2, int choices = 2) : choices(choices) {
+        int n = max(2, threads * queuesPerThread);
+        for (int i = 0; i < n; i++) shards.push_back(make_unique<Shard>());
+    }
+
+    void push(Item item) {
+        while (true) {
+            Shard& s = randomShard();
+            unique_lock<mutex> lock(s.m, try_to_lock);
+            if (!lock.owns_lock()) continue; // busy, just pick another heap
+            s.heap.push(move(item));
+            s.publishTop();
+            return;
+        }
+    }
+
+    bool tryPop(Item& out) {
+        for (int attempt = 0; attempt < 64; attempt++) {
+            Shard* best = nullptr;
+            int bestPriority = INT_MAX;
+            for (int c = 0; c < choices; c++) {
+                Shard& s = randomShard();
+                int p = s.topPriority.load(memory_order_relaxed);
+                if (p < bestPriority) {
+                    bestPriority = p;
+                    best = &s;
+                }
+            }
+            if (!best) continue; // sampled only empty heaps
+
+            unique_lock<mutex> lock(best->m, try_to_lock);
+            if (!lock.owns_lock() || best->heap.empty()) continue;
+            out = best->heap.top();
+            best->heap.pop();
+            best->publishTop();
+            return true;
+        }
+        // Random sampling kept missing: fall back to a full sweep before reporting empty
+        for (auto& s : shards) {
+            lock_guard<mutex> lock(s->m);
+            if (s->heap.empty()) continue;
+            out = s->heap.top();
+            s->heap.pop();
+            s->publishTop();
+            return true;
+        }
+        return false;
+    }
+};
+
+/* THROUGHPUT BENCHMARK
+   Prefill, then every thread alternates push and pop (a steady-state scheduler). */
+template <class Queue>
+double throughput(Queue& q, int threads, size_t opsPerThread) {
+    for (int i = 0; i < 100000; i++) q.push(Item(static_cast<int>(nextRandom() % 1000000), "task"));
+
+    atomic<bool> go{false};
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            while (!go.load()) this_thread::yield();
+            Item it(0, "");
+            for (size_t i = 0; i < opsPerThread; i++) {
+                if (q.tryPop(it)) {
+                    it.priority += static_cast<int>(nextRandom() % 1000);
+                    q.push(move(it));
+                }
+            }
+        });
+    }
+    auto t0 = chrono::steady_clock::now();
+    go = true;
+    for (auto& th : pool) th.join();
+    auto t1 = chrono::steady_clock::now();
+
+    double seconds = chrono::duration<double>(t1 - t0).count();
+    return 2.0 * threads * opsPerThread / seconds / 1e6; // million ops per second
+}
+
+void throughputSweep() {
+    cout << "Throughput (Mops/s, each op = pop + push pair counted as 2):\n";
+    cout << "threads   strict   multiqueue\n";
+    for (int threads : {1, 2, 4, 8, 16}) {
+        StrictQueue strict;
+        MultiQueue relaxed(threads);
+        double a = throughput(strict, threads, 200000);
+        double b = throughput(relaxed, threads, 200000);
+        cout << "  " << threads << "\t  " << a << "\t   " << b << "\n";
+    }
+}
+
+/* QUALITY: rank error
+   Fill with priorities 0..n-1, drain concurrently, and log the global pop order.
+   Rank error of a pop = how many strictly smaller priorities were still queued.
+   A Fenwick tree over priorities counts "already popped and smaller" in O(log n). */
+template <class Queue>
+void rankError(const string& name, Queue& q, int threads, int n) {
+    for (int i = 0; i < n; i++) q.push(Item(i, "task"));
+
+    vector<int> order(n);
+    atomic<int> position{0};
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            Item it(0, "");
+            while (q.tryPop(it)) order[position.fetch_add(1)] = it.priority;
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    vector<int> fenwick(n + 1, 0);
+    double total = 0;
+    long long worst = 0;
+    for (int i = 0; i < n; i++) {
+        int p = order[i];
+        int poppedSmaller = 0;
+        for (int j = p; j > 0; j -= j & -j) poppedSmaller += fenwick[j];
+        long long error = p - poppedSmaller; // smaller priorities still in the queue
+        total += error;
+        worst = max(worst, error);
+        for (int j = p + 1; j <= n; j += j & -j) fenwick[j]++;
+    }
+    cout << "  " << name << ": mean rank error " << total / n << ", max " << worst << "\n";
+}
+
+int main() {
+    throughputSweep();
+
+    // More threads than cores lets a thread be descheduled while holding a shard lock,
+    // which hides that shard's small priorities and inflates the measured error.
+    const int threads = static_cast<int>(max(1u, min(4u, thread::hardware_concurrency())));
+    const int n = 200000;
+    cout << "\nOrdering quality (" << threads << " threads, " << n << " items):\n";
+    StrictQueue strict;
+    rankError("strict         ", strict, threads, n);
+    MultiQueue relaxed(threads, 2, 2);
+    rankError("multiqueue c=2 ", relaxed, threads, n);
+    MultiQueue sloppier(threads, 8, 2);
+    rankError("multiqueue c=8 ", sloppier, threads, n);
+    MultiQueue tighter(threads, 2, 4);
+    rankError("multiqueue k=4 ", tighter, threads, n);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+================================= CONSTEXPR LOOKUP TABLES ==============================
+
+fib(n) and n! for every n whose result fits in 64 bits, computed by the COMPILER.
+
+- Only fib(0..92) and 0!..20! fit in a uint64_t (fib as in Recursion.cpp:
+  fib(0) = fib(1) = 1). That is 93 + 21 numbers: tiny tables.
+- The tables are std::array values built by constexpr functions (consteval when the
+  compiler supports C++20), so they are baked into the binary as constant data.
+  A lookup is a bounds check plus one load.
+- Beyond the table there is no 64-bit answer to fall back to: fibLookup(n) for n > 92
+  and factorialLookup(n) for n > 20 throw overflow_error, like fibFast() in
+  FastFibonacci.cpp. For larger n use fibMod() there (or BigInteger.cpp).
+- fibDoubling(), the fast-doubling algorithm from FastFibonacci.cpp as a constexpr
+  function, is checked against the table at compile time and timed against it below.
+- static_assert self-tests run at compile time: if a table entry were wrong, the
+  program would not compile.
+
+Needs C++17 (constexpr std::array access).
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+#if __cpp_consteval
+#define TABLE_BUILDER consteval
+#else
+#define TABLE_BUILDER constexpr
+#endif
+
+constexpr size_t FIB_TABLE_SIZE = 93;       // fib(92) = F(93) is the last that fits
+constexpr size_t FACTORIAL_TABLE_SIZE = 21; // 20! is the last that fits
+
+/* fib(n) = F(n+1) by fast doubling; usable both at compile time and at run time */
+constexpr uint64_t fibDoubling(uint64_t n) {
+    uint64_t k = n + 1;
+    uint64_t a = 0, b = 1; // F(0), F(1)
+    int bit = 63;
+    while (bit > 0 && !((k >> bit) & 1)) bit--;
+    for (; bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a);
+        uint64_t d = a * a + b * b;
+        if ((k >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+TABLE_BUILDER array<uint64_t, FIB_TABLE_SIZE> makeFibTable() {
+    array<uint64_t, FIB_TABLE_SIZE> t{};
+    t[0] = t[1] = 1;
+    for (size_t i = 2; i < FIB_TABLE_SIZE; i++) t[i] = t[i - 1] + t[i - 2];
+    return t;
+}
+
+TABLE_BUILDER array<uint64_t, FACTORIAL_TABLE_SIZE> makeFactorialTable() {
+    array<uint64_t, FACTORIAL_TABLE_SIZE> t{};
+    t[0] = 1;
+    for (size_t i = 1; i < FACTORIAL_TABLE_SIZE; i++) t[i] = t[i - 1] * i;
+    return t;
+}
+
+constexpr auto FIB_TABLE = makeFibTable();
+constexpr auto FACTORIAL_TABLE = makeFactorialTable();
+
+/* Compile-time self-tests */
+static_assert(FIB_TABLE[0] == 1 && FIB_TABLE[1] == 1 && FIB_TABLE[5] == 8, "fib convention");
+static_assert(FIB_TABLE[92] == 12200160415121876738ull, "largest 64-bit fib");
+static_assert(FIB_TABLE[92] > FIB_TABLE[91], "no wrap-around inside the table");
+static_assert(fibDoubling(92) == FIB_TABLE[92] && fibDoubling(50) == FIB_TABLE[50],
+              "table and fast doubling agree");
+static_assert(FACTORIAL_TABLE[0] == 1 && FACTORIAL_TABLE[6] == 720, "factorial basics");
+static_assert(FACTORIAL_TABLE[20] == 2432902008176640000ull, "largest 64-bit factorial");
+static_assert(FACTORIAL_TABLE[20] / 20 == FACTORIAL_TABLE[19], "no overflow inside the table");
+
+constexpr uint64_t fibLookup(uint64_t n) {
+    return n < FIB_TABLE_SIZE ? FIB_TABLE[n] : throw overflow_error("fib(n) does not fit in 64 bits for n > 92");
+}
+
+constexpr uint64_t factorialLookup(uint64_t n) {
+    return n < FACTORIAL_TABLE_SIZE ? FACTORIAL_TABLE[n]
+                                    : throw overflow_error("n! does not fit in 64 bits for n > 20");
+}
+
+static_assert(fibLookup(10) == 89 && factorialLookup(10) == 3628800, "lookups are usable in constant expressions");
+
+int main() {
+    cout << "fibLookup(45) = " << fibLookup(45) << "\n";
+    cout << "factorialLookup(20) = " << factorialLookup(20) << "\n";
+    try {
+        fibLookup(93);
+    } catch (const overflow_error& e) {
+        cout << "fibLookup(93) -> overflow_error: " << e.what() << "\n";
+    }
+
+    // Tiny timing comparison: table load vs computing by fast doubling
+    using Clock = chrono::steady_clock;
+    const int reps = 10000000;
+    volatile uint64_t input = 0;
+    uint64_t sink = 0;
+    auto t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        input = r % FIB_TABLE_SIZE;
+        sink += fibLookup(input);
+    }
+    auto t1 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        input = r % FIB_TABLE_SIZE;
+        sink -= fibDoubling(input);
+    }
+    auto t2 = Clock::now();
+    cout << "\nper call: table " << chrono::duration<double, nano>(t1 - t0).count() / reps
+         << " ns, fast doubling " << chrono::duration<double, nano>(t2 - t1).count() / reps
+         << " ns (results agree: " << (sink == 0 ? "yes" : "NO") << ")\n";
+    return 0;
+}
@@ -0,0 +1,483 @@
+/*
+==================================== DYNAMIC BITSET =====================================
+
+std::bitset<N> (see to_string().md) has its size fixed at compile time, and its
+to_string() produces the characters one bit at a time. For bit vectors with
+hundreds of millions of bits, sized at run time, we want something else.
+
+DynamicBitset
+  - Bits are packed into 64-bit words: bit i is bit (i % 64) of words[i / 64].
+    Unused bits of the last word are always kept 0, so whole-word operations
+    (count, compare, find) never need a special case for the tail.
+  - &=, |=, ^=, flip() and ~ work on whole words, 2 words (128 bits) per SSE2 instruction.
+    That is about as fast as the memory can deliver the data.
+  - count(): hardware popcnt when compiled with -mpopcnt / -march=native;
+    otherwise a pshufb nibble-table popcount (SSSE3), 128 bits at a time.
+  - findFirst() / findNext(i): skip zero words, then count trailing zeros inside the
+    first non-zero one. Iterating over k set bits costs O(k + words).
+  - rank(i) = number of set bits before position i, select(k) = position of the
+    k-th set bit (0-based). Both use a small index: the number of set bits before
+    each 512-bit block (64 bits per 512 = 12.5% extra memory), plus the block of every
+    4096th set bit so select() only searches between two such samples. Call
+    buildRankIndex() after the last modification; rank/select throw logic_error if
+    the index is stale.
+  - to_string() / fromString(): same format as std::bitset (highest bit first), but
+    16 characters per SSE2 step: one compare turns 16 '0'/'1' characters into 16 bits,
+    and a broadcast plus a mask test turns 16 bits into 16 characters.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <algorithm>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+using namespace std;
+
+class DynamicBitset {
+    static constexpr size_t BLOCK_WORDS = 8;     // rank index granularity: 512 bits
+    static constexpr size_t SELECT_SAMPLE = 4096; // select hint every 4096 set bits
+
+    vector<uint64_t> words;
+    size_t nbits = 0;
+    vector<uint64_t> blockRank;     // set bits before each block
+    vector<uint32_t> selectHint;    // block holding set bit number k * SELECT_SAMPLE
+    bool rankValid = false;
+
+    static size_t wordsFor(size_t bits) { return (bits + 63) / 64; }
+
+    void clearTail() {
+        if (nbits % 64) words.back() &= (1ull << (nbits % 64)) - 1;
+    }
+
+    void checkSameSize(const DynamicBitset& o) const {
+        if (o.nbits != nbits) throw invalid_argument("DynamicBitset: sizes differ");
+    }
+
+    enum class Op { And, Or, Xor };
+
+    template <Op op>
+    void combine(const DynamicBitset& o) {
+        checkSameSize(o);
+        uint64_t* a = words.data();
+        const uint64_t* b = o.words.data();
+        size_t n = words.size(), i = 0;
+#ifdef __SSE2__
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            __m128i r = op == Op::And ? _mm_and_si128(x, y) : op == Op::Or ? _mm_or_si128(x, y) : _mm_xor_si128(x, y);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), r);
+        }
+#endif
+        for (; i < n; i++) a[i] = op == Op::And ? a[i] & b[i] : op == Op::Or ? a[i] | b[i] : a[i] ^ b[i];
+        rankValid = false;
+    }
+
+    static int selectInWord(uint64_t w, unsigned k) {
+#ifdef __BMI2__
+        return __builtin_ctzll(_pdep_u64(1ull << k, w));
+#else
+        for (int byte = 0;; byte++) { // find the byte first, then the bit
+            unsigned c = static_cast<unsigned>(__builtin_popcount(static_cast<unsigned>((w >> (8 * byte)) & 0xFF)));
+            if (k < c) {
+                uint64_t b = (w >> (8 * byte)) & 0xFF;
+                for (; k; k--) b &= b - 1;
+                return 8 * byte + __builtin_ctzll(b);
+            }
+            k -= c;
+        }
+#endif
+    }
+
+public:
+    DynamicBitset() = default;
+    explicit DynamicBitset(size_t bits) : words(wordsFor(bits), 0), nbits(bits) {}
+
+    size_t size() const { return nbits; }
+
+    void resize(size_t bits) {
+        words.resize(wordsFor(bits), 0);
+        nbits = bits;
+        clearTail();
+        rankValid = false;
+    }
+
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) {
+        words[i / 64] |= 1ull << (i % 64);
+        rankValid = false;
+    }
+    void reset(size_t i) {
+        words[i / 64] &= ~(1ull << (i % 64));
+        rankValid = false;
+    }
+    void flip(size_t i) {
+        words[i / 64] ^= 1ull << (i % 64);
+        rankValid = false;
+    }
+
+    /* SET OPERATIONS */
+    DynamicBitset& operator&=(const DynamicBitset& o) {
+        combine<Op::And>(o);
+        return *this;
+    }
+    DynamicBitset& operator|=(const DynamicBitset& o) {
+        combine<Op::Or>(o);
+        return *this;
+    }
+    DynamicBitset& operator^=(const DynamicBitset& o) {
+        combine<Op::Xor>(o);
+        return *this;
+    }
+    /* Flip every bit, like std::bitset::flip() */
+    DynamicBitset& flip() {
+        uint64_t* a = words.data();
+        size_t n = words.size(), i = 0;
+#ifdef __SSE2__
+        const __m128i ones = _mm_set1_epi32(-1);
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), _mm_xor_si128(x, ones));
+        }
+#endif
+        for (; i < n; i++) a[i] = ~a[i];
+        clearTail();
+        rankValid = false;
+        return *this;
+    }
+    DynamicBitset operator~() const {
+        DynamicBitset r = *this;
+        return r.flip();
+    }
+    friend DynamicBitset operator&(DynamicBitset a, const DynamicBitset& b) { return a &= b; }
+    friend DynamicBitset operator|(DynamicBitset a, const DynamicBitset& b) { return a |= b; }
+    friend DynamicBitset operator^(DynamicBitset a, const DynamicBitset& b) { return a ^= b; }
+    bool operator==(const DynamicBitset& o) const { return nbits == o.nbits && words == o.words; }
+
+    /* POPCOUNT */
+    size_t count() const {
+        const uint64_t* w = words.data();
+        size_t n = words.size(), i = 0, total = 0;
+#if !defined(__POPCNT__) && defined(__SSSE3__)
+        // Without a popcnt instruction: look up the bit count of every nibble with pshufb,
+        // add the per-byte counts, and sum the bytes with psadbw.
+        const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m128i low = _mm_set1_epi8(0x0F);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 2 <= n; i += 2) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+            __m128i c = _mm_add_epi8(_mm_shuffle_epi8(table, _mm_and_si128(v, low)),
+                                     _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), low)));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(c, _mm_setzero_si128()));
+        }
+        total = static_cast<size_t>(_mm_cvtsi128_si64(acc)) + static_cast<size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+#endif
+        for (; i < n; i++) total += static_cast<size_t>(__builtin_popcountll(w[i]));
+        return total;
+    }
+
+    /* SCANNING: returns size() when there is no further set bit */
+    size_t findNext(size_t from) const {
+        if (from >= nbits) return nbits;
+        size_t wi = from / 64;
+        uint64_t w = words[wi] & (~0ull << (from % 64));
+        while (!w) {
+            if (++wi == words.size()) return nbits;
+            w = words[wi];
+        }
+        return wi * 64 + __builtin_ctzll(w);
+    }
+    size_t findFirst() const { return findNext(0); }
+
+    /* RANK / SELECT */
+    void buildRankIndex() {
+        size_t blocks = (words.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+        blockRank.assign(blocks + 1, 0); // blockRank[blocks] = total
+        for (size_t b = 0; b < blocks; b++) {
+            uint64_t c = 0;
+            for (size_t i = b * BLOCK_WORDS; i < min(words.size(), (b + 1) * BLOCK_WORDS); i++)
+                c += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+            blockRank[b + 1] = blockRank[b] + c;
+        }
+        selectHint.clear();
+        for (size_t b = 0, k = 0; b < blocks; b++)
+            for (; k < blockRank[b + 1]; k += SELECT_SAMPLE) selectHint.push_back(static_cast<uint32_t>(b));
+        rankValid = true;
+    }
+
+    /* Set bits in positions [0, i) */
+    size_t rank(size_t i) const {
+        if (!rankValid) throw logic_error("DynamicBitset::rank: call buildRankIndex() after modifying");
+        if (i > nbits) i = nbits;
+        size_t wi = i / 64, block = wi / BLOCK_WORDS;
+        size_t r = blockRank[block];
+        for (size_t k = block * BLOCK_WORDS; k < wi; k++) r += static_cast<size_t>(__builtin_popcountll(words[k]));
+        if (i % 64) r += static_cast<size_t>(__builtin_popcountll(words[wi] & ((1ull << (i % 64)) - 1)));
+        return r;
+    }
+
+    /* Position of the k-th set bit (k = 0 is the first), or size() if there are not that many */
+    size_t select(size_t k) const {
+        if (!rankValid) throw logic_error("DynamicBitset::select: call buildRankIndex() after modifying");
+        if (k >= blockRank.back()) return nbits;
+        // The hints narrow the search to the blocks between two samples; then binary search
+        // for the last block with at most k set bits before it
+        size_t sample = k / SELECT_SAMPLE;
+        size_t lo = selectHint[sample];
+        size_t hi = sample + 1 < selectHint.size() ? selectHint[sample + 1] + 1 : blockRank.size() - 1;
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (blockRank[mid] <= k) lo = mid;
+            else hi = mid;
+        }
+        k -= blockRank[lo];
+        for (size_t wi = lo * BLOCK_WORDS;; wi++) {
+            unsigned c = static_cast<unsigned>(__builtin_popcountll(words[wi]));
+            if (k < c) return wi * 64 + static_cast<size_t>(selectInWord(words[wi], static_cast<unsigned>(k)));
+            k -= c;
+        }
+    }
+
+    /* TEXT CONVERSION (highest bit first, like std::bitset) */
+    string to_string(char zero = '0', char one = '1') const {
+        string s(nbits, zero);
+        char* out = &s[0];
+        size_t fullWords = nbits / 64, lead = nbits % 64, pos = 0;
+        for (size_t b = lead; b-- > 0;) out[pos++] = test(fullWords * 64 + b) ? one : zero;
+#ifdef __SSE2__
+        const __m128i bitMask = _mm_setr_epi8(static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                              static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+        const __m128i zeros = _mm_set1_epi8(zero);
+        const __m128i diff = _mm_set1_epi8(static_cast<char>(one - zero));
+#endif
+        for (size_t wi = fullWords; wi-- > 0;) {
+            uint64_t w = words[wi];
+#ifdef __SSE2__
+            for (int pair = 3; pair >= 0; pair--) { // bytes 7,6 then 5,4 ... : 16 characters per step
+                unsigned hi = static_cast<unsigned>(w >> (16 * pair + 8)) & 0xFF;
+                unsigned lo = static_cast<unsigned>(w >> (16 * pair)) & 0xFF;
+                __m128i v = _mm_cvtsi32_si128(static_cast<int>(hi | (lo << 8)));
+                v = _mm_unpacklo_epi8(v, v);  // hi hi lo lo
+                v = _mm_unpacklo_epi16(v, v); // hi x4, lo x4
+                v = _mm_unpacklo_epi32(v, v); // hi x8, lo x8
+                __m128i isSet = _mm_cmpeq_epi8(_mm_and_si128(v, bitMask), bitMask);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_add_epi8(zeros, _mm_and_si128(isSet, diff)));
+                pos += 16;
+            }
+#else
+            for (int b = 63; b >= 0; b--) out[pos++] = (w >> b) & 1 ? one : zero;
+#endif
+        }
+        return s;
+    }
+
+    static DynamicBitset fromString(string_view s, char zero = '0', char one = '1') {
+        DynamicBitset r(s.size());
+        size_t n = s.size(), fullWords = n / 64, lead = n % 64;
+        auto bad = [&](size_t at) {
+            return invalid_argument("DynamicBitset::fromString: unexpected character at " + std::to_string(at));
+        };
+        // Character j holds bit n-1-j
+        for (size_t j = 0; j < lead; j++) {
+            if (s[j] == one) r.words[fullWords] |= 1ull << (lead - 1 - j);
+            else if (s[j] != zero) throw bad(j);
+        }
+#ifdef __SSE2__
+        static const auto reverseByte = [] {
+            array<uint8_t, 256> t{};
+            for (int b = 0; b < 256; b++)
+                for (int k = 0; k < 8; k++)
+                    if (b >> k & 1) t[b] |= static_cast<uint8_t>(1 << (7 - k));
+            return t;
+        }();
+        const __m128i ones = _mm_set1_epi8(one), zeros = _mm_set1_epi8(zero);
+#endif
+        for (size_t wi = 0; wi < fullWords; wi++) {
+            const char* chunk = s.data() + n - 64 * (wi + 1); // 64 characters, lowest bit last
+            uint64_t w = 0;
+#ifdef __SSE2__
+            for (int q = 0; q < 4; q++) {
+                const char* p = chunk + 48 - 16 * q; // bits 16q .. 16q+15
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i isOne = _mm_cmpeq_epi8(v, ones);
+                unsigned valid = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(isOne, _mm_cmpeq_epi8(v, zeros))));
+                if (valid != 0xFFFF) throw bad(static_cast<size_t>(p - s.data()) + __builtin_ctz(~valid));
+                unsigned m = static_cast<unsigned>(_mm_movemask_epi8(isOne)); // bit k = character k
+                uint64_t bits = static_cast<uint64_t>(reverseByte[m >> 8]) | static_cast<uint64_t>(reverseByte[m & 0xFF]) << 8;
+                w |= bits << (16 * q);
+            }
+#else
+            for (int k = 0; k < 64; k++) {
+                char c = chunk[63 - k];
+                if (c == one) w |= 1ull << k;
+                else if (c != zero) throw bad(static_cast<size_t>(chunk + 63 - k - s.data()));
+            }
+#endif
+            r.words[wi] = w;
+        }
+        return r;
+    }
+};
+
+/* DEMO */
+void demo() {
+    DynamicBitset a = DynamicBitset::fromString("1011001110001111000011111000001111110000000111111100000000");
+    cout << "a       = " << a.to_string() << " (" << a.count() << " set)\n";
+    DynamicBitset b(a.size());
+    for (size_t i = 0; i < b.size(); i += 3) b.set(i);
+    a &= b;
+    cout << "a & b   = " << a.to_string() << "\n";
+    a.buildRankIndex();
+    cout << "set bits at:";
+    for (size_t i = a.findFirst(); i < a.size(); i = a.findNext(i + 1)) cout << " " << i;
+    cout << "\nrank(30) = " << a.rank(30) << ", select(2) = " << a.select(2) << "\n";
+
+    bitset<12> std12(0xA5C);
+    DynamicBitset same = DynamicBitset::fromString(std12.to_string());
+    cout << "matches std::bitset: " << (same.to_string() == std12.to_string() ? "yes" : "NO") << "\n";
+}
+
+/* SELF-TEST against vector<bool> for sizes around word and block boundaries */
+bool selfTest() {
+    mt19937_64 rng(7);
+    size_t failures = 0;
+    for (size_t n : {0, 1, 63, 64, 65, 127, 511, 512, 513, 1000, 4097, 70001}) {
+        for (int density : {0, 1, 50, 100}) {
+            vector<bool> ra(n), rb(n);
+            DynamicBitset a(n), b(n);
+            for (size_t i = 0; i < n; i++) {
+                if (static_cast<int>(rng() % 100) < density) ra[i] = true, a.set(i);
+                if (rng() % 2) rb[i] = true, b.set(i);
+            }
+            DynamicBitset viaAndOr = (a | b) & ~(a & b);
+            a ^= b;
+            if (!(viaAndOr == a)) failures++;
+            for (size_t i = 0; i < n; i++) ra[i] = ra[i] != rb[i];
+
+            string expected;
+            for (size_t i = n; i-- > 0;) expected += ra[i] ? '1' : '0';
+            if (a.to_string() != expected || !(DynamicBitset::fromString(expected) == a)) failures++;
+
+            a.buildRankIndex();
+            size_t seen = 0, next = a.findFirst();
+            for (size_t i = 0; i <= n; i++) {
+                if (a.rank(i) != seen) failures++;
+                if (i == n) break;
+                if (ra[i]) {
+                    if (next != i || a.select(seen) != i) failures++;
+                    next = a.findNext(i + 1);
+                    seen++;
+                }
+            }
+            if (next != n || a.count() != seen || a.select(seen) != n) failures++;
+        }
+    }
+    try {
+        DynamicBitset::fromString(string(100, '1') + "2");
+        failures++;
+    } catch (const invalid_argument&) {
+    }
+    cout << "Self-test: " << failures << " failures\n";
+    return failures == 0;
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    const size_t n = 256u << 20; // 268 million bits, 32 MB per bitset
+    mt19937_64 rng(49);
+    DynamicBitset a(n), b(n), sparse(n);
+    for (size_t i = 0; i < n; i += 1 + rng() % 3) a.set(i);
+    for (size_t i = 0; i < n; i += 1 + rng() % 5) b.set(i);
+    for (size_t i = 0; i < n; i += 1 + rng() % 5000) sparse.set(i);
+    double mb = n / 8.0 / (1 << 20);
+
+    vector<bool> va(n), vb(n);
+    for (size_t i = 0; i < n; i++) {
+        va[i] = a.test(i);
+        vb[i] = b.test(i);
+    }
+    double tVecBool = timeMs([&] {
+        for (size_t i = 0; i < n; i++) va[i] = va[i] ^ vb[i];
+    });
+
+    DynamicBitset c = a;
+    double tAnd = timeMs([&] { c &= b; });
+    double tOr = timeMs([&] { c |= b; });
+    double tXor = timeMs([&] { c ^= a; });
+    size_t count = 0;
+    double tCount = timeMs([&] { count = c.count(); });
+    size_t visited = 0;
+    double tScan = timeMs([&] {
+        for (size_t i = sparse.findFirst(); i < n; i = sparse.findNext(i + 1)) visited++;
+    });
+    cout << "\nBenchmark (" << n << " bits, " << mb << " MB per bitset):\n"
+         << "  per-bit XOR on vector<bool> " << tVecBool << " ms\n"
+         << "  AND " << tAnd << " ms, OR " << tOr << " ms, XOR " << tXor << " ms (" << mb * 3 / tXor
+         << " GB/s of traffic for XOR)\n"
+         << "  count " << tCount << " ms (" << count << " set), findNext over " << visited << " sparse bits " << tScan
+         << " ms\n";
+
+    a.buildRankIndex();
+    size_t total = a.count(), checksum = 0;
+    const int queries = 2000000;
+    double tRank = timeMs([&] {
+        for (int q = 0; q < queries; q++) checksum += a.rank(rng() % n);
+    });
+    bool selectOk = true;
+    double tSelect = timeMs([&] {
+        for (int q = 0; q < queries; q++) {
+            size_t k = rng() % total;
+            size_t pos = a.select(k);
+            checksum += pos;
+            if (q % 1000 == 0) selectOk = selectOk && a.test(pos) && a.rank(pos) == k;
+        }
+    });
+    cout << "  " << queries << " rank queries " << tRank << " ms, select " << tSelect << " ms ("
+         << (selectOk ? "consistent" : "INCONSISTENT") << ")\n";
+
+    string text;
+    double tToString = timeMs([&] { text = a.to_string(); });
+    DynamicBitset back;
+    double tFromString = timeMs([&] { back = DynamicBitset::fromString(text); });
+
+    static bitset<1 << 24> fixed; // std::bitset for comparison, 16M bits
+    for (size_t i = 0; i < fixed.size(); i++) fixed[i] = a.test(i);
+    double tStd = timeMs([&] { checksum += fixed.to_string().size(); });
+    cout << "  to_string " << tToString << " ms, fromString " << tFromString << " ms ("
+         << (back == a ? "round trip ok" : "ROUND TRIP FAILED") << "); std::bitset<2^24>::to_string "
+         << tStd << " ms for 1/16 of the bits\n";
+}
+
+int main() {
+    demo();
+    if (!selfTest()) return 1;
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,395 @@
+/*
+=============================== EXTERNAL PRIORITY QUEUE ================================
+
+A priority queue for backlogs of Items larger than RAM.
+
+Same interface and ordering as priority_queue<Item, vector<Item>, CompareItem>
+(push / top / pop / empty / size, lowest priority value first), but memory is capped:
+
+- Hot heap
+    New Items go into an ordinary in-memory heap. When its estimated size reaches
+    half the memory budget, it is sorted and written to disk as one sorted "run".
+
+- Runs on disk
+    Each run is read back through its own large buffer (sequential fread, no seeking).
+    Only the head Item of every run is in memory. A small heap of run heads performs
+    the k-way merge, so pop() costs O(log k) plus an amortized sliver of a buffer refill.
+
+- Run compaction
+    Every run needs a read buffer, so the number of runs is limited by the other half
+    of the budget. When the limit is hit, the smaller half of the runs is merged into
+    one bigger run (again purely sequential I/O) before the new run is written.
+    If that half cannot hold three I/O buffers, the buffers are shrunk to fit.
+
+top() compares the hot heap's best Item with the best run head, so Items pushed after
+a spill still come out in the right place.
+
+Run file record format: [int32 priority][uint32 length][length bytes of description]
+
+Usage: ExternalPriorityQueue [items] [memoryMB]   (defaults: 100000000 items, 256 MB)
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* Buffered sequential writer for one run (records are packed into our own buffer so
+   the FILE is only touched once per buffer, not once per field) */
+class RunWriter {
+    FILE* file;
+    vector<char> buffer;
+    size_t used = 0;
+
+    void append(const void* data, size_t n) {
+        const char* src = static_cast<const char*>(data);
+        while (n > 0) {
+            if (used == buffer.size()) flush();
+            size_t chunk = min(n, buffer.size() - used);
+            memcpy(buffer.data() + used, src, chunk);
+            used += chunk;
+            src += chunk;
+            n -= chunk;
+        }
+    }
+
+    void flush() {
+        if (used > 0 && fwrite(buffer.data(), 1, used, file) != used)
+            throw runtime_error("failed to write run file");
+        used = 0;
+    }
+
+public:
+    RunWriter(const string& path, size_t bufferSize) : buffer(bufferSize) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) throw runtime_error("cannot create run file " + path);
+    }
+    ~RunWriter() {
+        if (file) fclose(file);
+    }
+
+    void close() {
+        flush();
+        fclose(file);
+        file = nullptr;
+    }
+
+    void write(const Item& item) {
+        int32_t priority = item.priority;
+        uint32_t length = static_cast<uint32_t>(item.description.size());
+        append(&priority, sizeof priority);
+        append(&length, sizeof length);
+        append(item.description.data(), length);
+    }
+};
+
+/* Buffered sequential reader for one run; always holds the next Item in 'head' */
+class RunReader {
+    string path;
+    FILE* file;
+    vector<char> buffer;
+    size_t pos = 0, end = 0;
+    bool exhausted = false;
+
+    bool read(void* out, size_t n) {
+        char* dst = static_cast<char*>(out);
+        while (n > 0) {
+            if (pos == end) {
+                end = fread(buffer.data(), 1, buffer.size(), file);
+                pos = 0;
+                if (end == 0) return false;
+            }
+            size_t chunk = min(n, end - pos);
+            memcpy(dst, buffer.data() + pos, chunk);
+            pos += chunk;
+            dst += chunk;
+            n -= chunk;
+        }
+        return true;
+    }
+
+    void load() {
+        int32_t priority;
+        uint32_t length;
+        if (!read(&priority, sizeof priority) || !read(&length, sizeof length)) {
+            exhausted = true;
+            return;
+        }
+        head.priority = priority;
+        head.description.resize(length);
+        if (!read(&head.description[0], length)) throw runtime_error("truncated run file " + path);
+    }
+
+public:
+    Item head{0, ""};
+    size_t remaining;  // Items not yet consumed, including head
+
+    RunReader(string p, size_t items, size_t bufferSize)
+        : path(move(p)), buffer(bufferSize), remaining(items) {
+        file = fopen(path.c_str(), "rb");
+        if (!file) throw runtime_error("cannot open run file " + path);
+        load();
+    }
+    ~RunReader() {
+        fclose(file);
+        filesystem::remove(path);
+    }
+
+    bool done() const { return exhausted; }
+
+    void advance() {
+        remaining--;
+        load();
+    }
+};
+
+class ExternalPriorityQueue {
+    vector<Item> hot;                // binary heap ordered by CompareItem
+    size_t hotChars = 0;             // heap-allocated description bytes of the hot Items
+    size_t hotLimit;                 // bytes the hot heap may use before spilling
+    size_t bufferSize;               // per-run I/O buffer
+    size_t maxRuns;
+
+    static constexpr size_t MIN_RUNS = 2; // compaction needs at least two runs to merge
+
+    vector<unique_ptr<RunReader>> runs;
+    using Head = pair<int, size_t>;  // (priority of run head, run index)
+    priority_queue<Head, vector<Head>, greater<Head>> heads;
+
+    string directory;
+    size_t runCounter = 0;
+    size_t count = 0;
+
+    static size_t heapChars(const Item& item) {
+        return item.description.capacity() > 15 ? item.description.capacity() + 1 : 0;
+    }
+
+    string nextRunPath() {
+        return directory + "/extpq-" + to_string(reinterpret_cast<uintptr_t>(this)) + "-" +
+               to_string(runCounter++) + ".run";
+    }
+
+    void addRun(const string& path, size_t items) {
+        runs.push_back(make_unique<RunReader>(path, items, bufferSize));
+        rebuildHeads();
+    }
+
+    void rebuildHeads() {
+        heads = {};
+        for (size_t r = 0; r < runs.size(); r++)
+            if (!runs[r]->done()) heads.push({runs[r]->head.priority, r});
+    }
+
+    /* Merge the smaller half of the runs into one new run (sequential I/O only).
+       Always merging the smallest runs keeps the total rewrite cost O(n log n),
+       like the tiered compaction of an LSM tree. */
+    void compactRuns() {
+        sort(runs.begin(), runs.end(), [](const auto& a, const auto& b) { return a->remaining < b->remaining; });
+        size_t merging = runs.size() / 2 + 1;
+
+        priority_queue<Head, vector<Head>, greater<Head>> local;
+        for (size_t r = 0; r < merging; r++)
+            if (!runs[r]->done()) local.push({runs[r]->head.priority, r});
+
+        string path = nextRunPath();
+        size_t written = 0;
+        {
+            RunWriter out(path, bufferSize);
+            while (!local.empty()) {
+                size_t r = local.top().second;
+                local.pop();
+                out.write(runs[r]->head);
+                written++;
+                runs[r]->advance();
+                if (!runs[r]->done()) local.push({runs[r]->head.priority, r});
+            }
+            out.close();
+        }
+        runs.erase(runs.begin(), runs.begin() + merging);
+        addRun(path, written);
+    }
+
+    void spill() {
+        if (runs.size() >= maxRuns) compactRuns();
+        sort(hot.begin(), hot.end(), [](const Item& a, const Item& b) { return a.priority < b.priority; });
+        string path = nextRunPath();
+        {
+            RunWriter out(path, bufferSize);
+            for (const Item& item : hot) out.write(item);
+            out.close();
+        }
+        size_t written = hot.size();
+        hot.clear(); // keeps the reserved capacity for the next cycle
+        hotChars = 0;
+        addRun(path, written);
+    }
+
+    bool hotIsBest() const {
+        if (heads.empty()) return true;
+        return !hot.empty() && hot.front().priority <= heads.top().first;
+    }
+
+public:
+    explicit ExternalPriorityQueue(size_t memoryBudget, size_t ioBuffer = 1 << 20,
+                                   string dir = filesystem::temp_directory_path().string())
+        : hotLimit(memoryBudget / 2), directory(move(dir)) {
+        // The run half of the budget must hold maxRuns reader buffers plus the one writer
+        // buffer a compaction briefly needs, so shrink the buffers when it is too small
+        size_t runBudget = memoryBudget / 2;
+        bufferSize = min(ioBuffer, runBudget / (MIN_RUNS + 1));
+        if (bufferSize == 0)
+            throw invalid_argument("ExternalPriorityQueue: need a non-zero I/O buffer and a memory budget of at least " +
+                                   to_string(2 * (MIN_RUNS + 1)) + " bytes");
+        maxRuns = runBudget / bufferSize - 1;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t runsOnDisk() const { return runs.size(); }
+    size_t runsWritten() const { return runCounter; }
+    size_t maxRunsOnDisk() const { return maxRuns; }
+
+    void push(Item item) {
+        // The slot array is reserved once for the whole hot budget and kept across spills:
+        // growing by push_back would briefly hold the old and the new array. Its pages are
+        // only touched up to the largest size reached, which the spill test below bounds
+        // together with the descriptions.
+        if (hot.capacity() == 0) hot.reserve(max<size_t>(1, hotLimit / sizeof(Item)));
+        hotChars += heapChars(item);
+        hot.push_back(move(item));
+        push_heap(hot.begin(), hot.end(), CompareItem());
+        count++;
+        if (hot.size() == hot.capacity() || hot.size() * sizeof(Item) + hotChars >= hotLimit) spill();
+    }
+
+    const Item& top() const {
+        return hotIsBest() ? hot.front() : runs[heads.top().second]->head;
+    }
+
+    void pop() {
+        count--;
+        if (hotIsBest()) {
+            hotChars -= heapChars(hot.front());
+            pop_heap(hot.begin(), hot.end(), CompareItem());
+            hot.pop_back();
+            return;
+        }
+        size_t r = heads.top().second;
+        heads.pop();
+        runs[r]->advance();
+        if (!runs[r]->done()) heads.push({runs[r]->head.priority, r});
+        else if (heads.empty()) runs.clear(); // every run drained: delete the files
+    }
+};
+
+/* DEMO: a tiny memory budget forces spills even for a handful of Items */
+void basicDemo() {
+    ExternalPriorityQueue itemQueue(4 * sizeof(Item), 64);
+    itemQueue.push(Item(3, "Whey Protein"));
+    itemQueue.push(Item(1, "Eggs"));
+    itemQueue.push(Item(5, "Dumbbells"));
+    itemQueue.push(Item(2, "Cables"));
+
+    cout << "Items in order of priority (" << itemQueue.runsWritten() << " runs spilled):\n";
+    while (!itemQueue.empty()) {
+        const Item& i = itemQueue.top();
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+        itemQueue.pop();
+    }
+}
+
+/* SELF-TEST: a budget smaller than the default I/O buffer, and one too small to use */
+bool selfTest() {
+    size_t failures = 0;
+    ExternalPriorityQueue pq(1 << 20); // 1 MB budget, default 1 MB buffer
+    if (pq.maxRunsOnDisk() < 2 || pq.maxRunsOnDisk() > 8) failures++;
+    mt19937 rng(3);
+    for (int i = 0; i < 200000; i++) {
+        pq.push(Item(static_cast<int>(rng() % 1000000), "job"));
+        if (pq.runsOnDisk() > pq.maxRunsOnDisk()) failures++;
+    }
+    if (pq.runsWritten() < 2) failures++;
+    int last = -1;
+    size_t popped = 0;
+    for (; !pq.empty(); pq.pop(), popped++) {
+        if (pq.top().priority < last) failures++;
+        last = pq.top().priority;
+    }
+    if (popped != 200000) failures++;
+    try {
+        ExternalPriorityQueue tooSmall(4);
+        failures++;
+    } catch (const invalid_argument&) {
+    }
+    cout << "\nSelf-test: " << failures << " failures\n";
+    return failures == 0;
+}
+
+/* BENCHMARK: push the whole backlog, then drain it */
+void benchmark(size_t n, size_t memoryMB) {
+    using Clock = chrono::steady_clock;
+    ExternalPriorityQueue pq(memoryMB << 20);
+    mt19937 rng(5);
+    uniform_int_distribution<int> dist(0, INT32_MAX);
+
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < n; i++) pq.push(Item(dist(rng), "job"));
+    auto t1 = Clock::now();
+    size_t runs = pq.runsWritten();
+
+    int last = -1;
+    bool ordered = true;
+    while (!pq.empty()) {
+        int p = pq.top().priority;
+        if (p < last) ordered = false;
+        last = p;
+        pq.pop();
+    }
+    auto t2 = Clock::now();
+
+    double pushSeconds = chrono::duration<double>(t1 - t0).count();
+    double popSeconds = chrono::duration<double>(t2 - t1).count();
+    cout << "\nBenchmark (" << n << " items, " << memoryMB << " MB budget):\n"
+         << "  push: " << pushSeconds << " s (" << n / pushSeconds / 1e6 << " M pushes/s), "
+         << runs << " run files written\n"
+         << "  pop:  " << popSeconds << " s (" << n / popSeconds / 1e6 << " M pops/s)\n"
+         << "  output sorted: " << (ordered ? "yes" : "NO") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? stoull(argv[1]) : 100000000;
+    size_t memoryMB = argc > 2 ? stoull(argv[2]) : 256;
+
+    basicDemo();
+    if (!selfTest()) return 1;
+    benchmark(n, memoryMB);
+    return 0;
+}
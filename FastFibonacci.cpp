@@ -0,0 +1,126 @@
+/*
+==================================== FAST FIBONACCI ====================================
+
+O(log n) Fibonacci numbers.
+
+The fib() in Recursion.cpp calls itself twice per level and recomputes the same
+subproblems over and over, so it runs in O(phi^n): fib(45) takes seconds.
+Note its convention: fib(0) = fib(1) = 1, so fib(n) is the (n+1)-th Fibonacci
+number F(n+1) with F(0) = 0, F(1) = 1. Everything below keeps that convention.
+
+Matrix form:
+    | F(k+1)  F(k)   |   =   | 1 1 | ^ k
+    | F(k)    F(k-1) |       | 1 0 |
+  Raising the matrix to the k-th power by repeated squaring takes O(log k) steps.
+
+Fast doubling (the same idea with the redundant matrix entries removed):
+    F(2k)   = F(k) * (2*F(k+1) - F(k))
+    F(2k+1) = F(k)^2 + F(k+1)^2
+  Walk the bits of n from the top; each bit doubles k, and a 1 bit adds one more step.
+
+Three entry points:
+  - fibFast(n):     exact 64-bit result, throws overflow_error past fib(92)
+                    (F(93) is the largest Fibonacci number that fits in 64 bits).
+  - fibMod(n, m):   fib(n) modulo m, for any n up to 2^64 - 1 (uses 128-bit products).
+  - fibRecursive(n): the original exponential version, kept for the benchmark.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+/* The exponential version from Recursion.cpp */
+int fibRecursive(int n) {
+    if (n < 2) {
+        return 1;
+    }
+    return fibRecursive(n - 2) + fibRecursive(n - 1);
+}
+
+/* Returns (F(k), F(k+1)) by fast doubling; only valid while F(k+1) fits in 64 bits */
+static pair<uint64_t, uint64_t> fibPair(uint64_t k) {
+    uint64_t a = 0, b = 1; // F(0), F(1)
+    for (int bit = 63 - __builtin_clzll(k | 1); bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a); // F(2j)
+        uint64_t d = a * a + b * b;   // F(2j+1)
+        if ((k >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return {a, b};
+}
+
+/* fib(n) as in Recursion.cpp, i.e. F(n+1) */
+uint64_t fibFast(uint64_t n) {
+    if (n > 92) throw overflow_error("fibFast: fib(n) does not fit in 64 bits for n > 92");
+    return fibPair(n).second;
+}
+
+/* fib(n) mod m, i.e. F(n+1) mod m, for any n */
+uint64_t fibMod(uint64_t n, uint64_t m) {
+    if (m == 0) throw invalid_argument("fibMod: modulus must be positive");
+    using u128 = unsigned __int128;
+    uint64_t a = 0, b = 1 % m; // F(0), F(1) mod m
+    // Walk the bits of n + 1 (F(n+1) is what we want); handle n = 2^64 - 1 via one extra step
+    uint64_t k = n + 1;
+    bool extra = (k == 0);
+    if (extra) k = n;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t twoBminusA = (2 * static_cast<u128>(b) + m - a) % m;
+        uint64_t c = static_cast<uint64_t>(static_cast<u128>(a) * twoBminusA % m);
+        uint64_t d = static_cast<uint64_t>((static_cast<u128>(a) * a + static_cast<u128>(b) * b) % m);
+        if ((k >> bit) & 1) {
+            a = d;
+            b = (c + static_cast<u128>(d)) % m;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return extra ? b : a;
+}
+
+/* BENCHMARK */
+void benchmark() {
+    using Clock = chrono::steady_clock;
+    cout << "  n   fibRecursive        time      fibFast          time\n";
+    for (int n : {10, 20, 25, 30, 35, 40}) {
+        auto t0 = Clock::now();
+        int slow = fibRecursive(n);
+        auto t1 = Clock::now();
+        uint64_t fast = 0;
+        const int reps = 1000000;
+        volatile uint64_t input = n; // stops the compiler from folding the calls away
+        for (int r = 0; r < reps; r++) fast = fibFast(input);
+        auto t2 = Clock::now();
+        cout << "  " << n << "  " << slow << "\t" << chrono::duration<double, micro>(t1 - t0).count()
+             << " us\t" << fast << "\t" << chrono::duration<double, nano>(t2 - t1).count() / reps
+             << " ns" << (static_cast<uint64_t>(slow) == fast ? "" : "  MISMATCH") << "\n";
+    }
+}
+
+int main() {
+    cout << "fibFast(45) = " << fibFast(45) << "\n";
+    cout << "fibFast(92) = " << fibFast(92) << "  (largest that fits in 64 bits)\n";
+    try {
+        fibFast(93);
+    } catch (const overflow_error& e) {
+        cout << "fibFast(93) -> overflow_error: " << e.what() << "\n";
+    }
+    cout << "fibMod(10^18, 10^9 + 7) = " << fibMod(1000000000000000000ull, 1000000007) << "\n";
+    cout << "fibMod(2^64 - 1, 10^9 + 7) = " << fibMod(UINT64_MAX, 1000000007) << "\n";
+    cout << "fibMod(92, 10^9 + 7) == fibFast(92) % (10^9 + 7): "
+         << (fibMod(92, 1000000007) == fibFast(92) % 1000000007 ? "yes" : "NO") << "\n\n";
+
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,553 @@
+/*
+==================================== FAST TO_STRING =====================================
+
+std::to_string (see to_string().md and the "Converting Integer to String" example in
+Strings.cpp) is convenient but slow in hot loops:
+  - it returns a new std::string every time (an allocation for longer results),
+  - for doubles it goes through printf("%f"): locale checks, format-string parsing,
+    and it prints a FIXED 6 decimals: to_string(1e-7) == "0.000000", and
+    to_string(0.1 + 0.2) == "0.300000" -- the value does not survive a round trip.
+
+This file writes numbers into a buffer the CALLER provides, and never allocates:
+
+writeInt(buf, value) -> end pointer
+  - Counts the digits first (bit length * log10(2), corrected with one table lookup),
+    then fills the buffer from the right two digits at a time using a 200-byte table
+    "00" "01" ... "99". Half the divisions of the digit-by-digit loop.
+  - buf needs MAX_INT_CHARS (20) characters.
+  - Measured gain is modest: about 1.3x over std::to_string for random int64s, and
+    1.2x when joining them into one string. libstdc++'s to_string already uses the same
+    two-digit table, and results up to 15 characters fit its small-string buffer,
+    so only the allocation of longer results is saved. The multi-x gains are for
+    doubles (below): about 7x over to_string and 10x over snprintf.
+
+writeDouble(buf, value) -> end pointer
+  - The SHORTEST decimal that reads back as exactly the same double, found with the
+    Ryu algorithm (Ulf Adams, 2018):
+      * The double is m * 2^e. The decimals that still round to it form an interval
+        (halfway to each neighbouring double).
+      * Multiply the interval bounds by a precomputed 125-bit power of 5 (a table
+        lookup and two 64x64->128 multiplications) to get them in base 10.
+      * Drop trailing digits while both bounds still agree on the remaining ones.
+    Integer arithmetic only: no printf, no locale, no loops over long digit strings.
+  - The power-of-5 tables are computed once at startup with a small big-number
+    routine instead of being pasted in as 660 constants.
+  - Output format is that of std::to_chars(buf, end, value): fixed or scientific,
+    whichever is shorter ("0.1", "100", "1e+21", "5e-324"). The self-test compares
+    the two on millions of random doubles.
+  - buf needs MAX_DOUBLE_CHARS (24) characters.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+using namespace std;
+
+constexpr size_t MAX_INT_CHARS = 20;    // "-9223372036854775808", "18446744073709551615"
+constexpr size_t MAX_DOUBLE_CHARS = 24; // "-2.2250738585072014e-308"
+
+/* INTEGERS */
+
+static const char DIGIT_PAIRS[] = "00010203040506070809"
+                                  "10111213141516171819"
+                                  "20212223242526272829"
+                                  "30313233343536373839"
+                                  "40414243444546474849"
+                                  "50515253545556575859"
+                                  "60616263646566676869"
+                                  "70717273747576777879"
+                                  "80818283848586878889"
+                                  "90919293949596979899";
+
+static const uint64_t POW10[20] = {1ull,
+                                   10ull,
+                                   100ull,
+                                   1000ull,
+                                   10000ull,
+                                   100000ull,
+                                   1000000ull,
+                                   10000000ull,
+                                   100000000ull,
+                                   1000000000ull,
+                                   10000000000ull,
+                                   100000000000ull,
+                                   1000000000000ull,
+                                   10000000000000ull,
+                                   100000000000000ull,
+                                   1000000000000000ull,
+                                   10000000000000000ull,
+                                   100000000000000000ull,
+                                   1000000000000000000ull,
+                                   10000000000000000000ull};
+
+static inline int digitCount(uint64_t v) {
+    int t = (64 - __builtin_clzll(v | 1)) * 1233 >> 12; // ~ bit length * log10(2)
+    return t + ((v | 1) >= POW10[t]); // v | 1: zero still has one digit
+}
+
+char* writeUnsigned(char* buf, uint64_t v) {
+    char* end = buf + digitCount(v);
+    char* p = end;
+    while (v >= 100) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + 2 * (v % 100), 2);
+        v /= 100;
+    }
+    if (v >= 10) memcpy(p - 2, DIGIT_PAIRS + 2 * v, 2);
+    else p[-1] = static_cast<char>('0' + v);
+    return end;
+}
+
+template <class T>
+char* writeInt(char* buf, T value) {
+    static_assert(is_integral_v<T>, "writeInt needs an integer type");
+    if constexpr (is_signed_v<T>) {
+        if (value < 0) {
+            *buf++ = '-';
+            return writeUnsigned(buf, 0 - static_cast<uint64_t>(value)); // well defined for INT64_MIN too
+        }
+    }
+    return writeUnsigned(buf, static_cast<uint64_t>(value));
+}
+
+/* DOUBLES: Ryu */
+
+namespace ryu {
+
+using u128 = unsigned __int128;
+
+constexpr int POW5_BITCOUNT = 125;
+constexpr int POW5_INV_BITCOUNT = 125;
+constexpr int POW5_TABLE_SIZE = 326;
+constexpr int POW5_INV_TABLE_SIZE = 342;
+
+/* Minimal unsigned big integer, only for building the tables */
+struct Big {
+    vector<uint32_t> limbs; // little endian
+
+    int bitLength() const {
+        for (size_t i = limbs.size(); i-- > 0;)
+            if (limbs[i]) return static_cast<int>(i * 32 + 32 - __builtin_clz(limbs[i]));
+        return 0;
+    }
+    bool bit(int i) const { return (limbs[i / 32] >> (i % 32)) & 1; }
+    void mulSmall(uint32_t f) {
+        uint64_t carry = 0;
+        for (uint32_t& l : limbs) {
+            uint64_t x = static_cast<uint64_t>(l) * f + carry;
+            l = static_cast<uint32_t>(x);
+            carry = x >> 32;
+        }
+        if (carry) limbs.push_back(static_cast<uint32_t>(carry));
+    }
+};
+
+struct Tables {
+    u128 pow5[POW5_TABLE_SIZE];        // 5^i scaled to exactly 125 bits (truncated)
+    u128 pow5Inv[POW5_INV_TABLE_SIZE]; // floor(2^(bitlen(5^i) - 1 + 125) / 5^i) + 1
+
+    Tables() {
+        Big p{{1}};
+        for (int i = 0; i < max(POW5_TABLE_SIZE, POW5_INV_TABLE_SIZE); i++) {
+            int len = p.bitLength();
+            if (i < POW5_TABLE_SIZE) {
+                // top 125 bits of 5^i (shifted left if 5^i is shorter)
+                u128 v = 0;
+                for (int b = len - 1; b >= max(0, len - POW5_BITCOUNT); b--) v = (v << 1) | p.bit(b);
+                if (len < POW5_BITCOUNT) v <<= (POW5_BITCOUNT - len);
+                pow5[i] = v;
+            }
+            if (i < POW5_INV_TABLE_SIZE) pow5Inv[i] = inverse(p, len - 1 + POW5_INV_BITCOUNT) + 1;
+            p.mulSmall(5);
+        }
+    }
+
+    /* floor(2^j / d) by binary long division; the quotient has at most 126 bits */
+    static u128 inverse(const Big& d, int j) {
+        vector<uint32_t> r(d.limbs.size() + 1, 0);
+        u128 q = 0;
+        for (int b = j; b >= 0; b--) {
+            // r = 2r + (bit b of 2^j)
+            uint32_t carry = b == j;
+            for (uint32_t& l : r) {
+                uint32_t next = l >> 31;
+                l = (l << 1) | carry;
+                carry = next;
+            }
+            // if r >= d: r -= d
+            bool ge = true;
+            for (size_t k = r.size(); k-- > 0;) {
+                uint32_t dk = k < d.limbs.size() ? d.limbs[k] : 0;
+                if (r[k] != dk) {
+                    ge = r[k] > dk;
+                    break;
+                }
+            }
+            q <<= 1;
+            if (ge) {
+                int64_t borrow = 0;
+                for (size_t k = 0; k < r.size(); k++) {
+                    int64_t x = static_cast<int64_t>(r[k]) - (k < d.limbs.size() ? d.limbs[k] : 0) - borrow;
+                    borrow = x < 0;
+                    r[k] = static_cast<uint32_t>(x);
+                }
+                q |= 1;
+            }
+        }
+        return q;
+    }
+};
+
+static const Tables& tables() {
+    static const Tables t; // built once, on first use
+    return t;
+}
+
+static inline int pow5bits(int e) { return static_cast<int>((static_cast<uint32_t>(e) * 1217359) >> 19) + 1; }
+static inline int log10Pow2(int e) { return static_cast<int>((static_cast<uint32_t>(e) * 78913) >> 18); }
+static inline int log10Pow5(int e) { return static_cast<int>((static_cast<uint32_t>(e) * 732923) >> 20); }
+
+static inline int pow5Factor(uint64_t v) {
+    int count = 0;
+    while (v % 5 == 0) {
+        v /= 5;
+        count++;
+    }
+    return count;
+}
+static inline bool multipleOfPowerOf5(uint64_t v, int p) { return pow5Factor(v) >= p; }
+static inline bool multipleOfPowerOf2(uint64_t v, int p) { return (v & ((1ull << p) - 1)) == 0; }
+
+static inline uint64_t mulShift(uint64_t m, u128 mul, int j) {
+    u128 b0 = static_cast<u128>(m) * static_cast<uint64_t>(mul);
+    u128 b2 = static_cast<u128>(m) * static_cast<uint64_t>(mul >> 64);
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+}
+
+/* Shortest decimal digits and exponent: value == output * 10^exponent.
+   Kept out of line: inlined into writeDouble, GCC 12 produced code twice as slow. */
+__attribute__((noinline)) static void shortest(uint64_t ieeeMantissa, uint32_t ieeeExponent, uint64_t& output, int& exponent) {
+    const Tables& t = tables();
+    int e2;
+    uint64_t m2;
+    if (ieeeExponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = static_cast<int>(ieeeExponent) - 1023 - 52 - 2;
+        m2 = (1ull << 52) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0; // round-to-even: the bounds themselves read back correctly
+
+    // Interval of decimals that read back as this double, scaled by 4: [mm, mp] around mv
+    uint64_t mv = 4 * m2;
+    uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1; // lower gap is half as wide at powers of 2
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false, vrIsTrailingZeros = false;
+    if (e2 >= 0) {
+        int q = log10Pow2(e2) - (e2 > 3);
+        e10 = q;
+        int k = POW5_INV_BITCOUNT + pow5bits(q) - 1;
+        int i = -e2 + q + k;
+        vr = mulShift(4 * m2, t.pow5Inv[q], i);
+        vp = mulShift(4 * m2 + 2, t.pow5Inv[q], i);
+        vm = mulShift(4 * m2 - 1 - mmShift, t.pow5Inv[q], i);
+        if (q <= 21) {
+            if (mv % 5 == 0) vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            else if (acceptBounds) vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            else vp -= multipleOfPowerOf5(mv + 2, q);
+        }
+    } else {
+        int q = log10Pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5bits(i) - POW5_BITCOUNT;
+        int j = q - k;
+        vr = mulShift(4 * m2, t.pow5[i], j);
+        vp = mulShift(4 * m2 + 2, t.pow5[i], j);
+        vm = mulShift(4 * m2 - 1 - mmShift, t.pow5[i], j);
+        if (q <= 1) {
+            vrIsTrailingZeros = true;
+            if (acceptBounds) vmIsTrailingZeros = mmShift == 1;
+            else vp--;
+        } else if (q < 63) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // Remove digits while the interval still contains a shorter number
+    int removed = 0;
+    uint8_t lastRemovedDigit = 0;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) { // rare: exact ties need careful rounding
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) lastRemovedDigit = 4; // round half to even
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    } else {
+        bool roundUp = false;
+        if (vp / 100 > vm / 100) { // most doubles lose many digits: take two per step at first
+            roundUp = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            roundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || roundUp);
+    }
+    exponent = e10 + removed;
+}
+
+} // namespace ryu
+
+char* writeDouble(char* buf, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    bool sign = bits >> 63;
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+    uint32_t exponent = static_cast<uint32_t>((bits >> 52) & 0x7FF);
+
+    if (sign) *buf++ = '-';
+    if (exponent == 0x7FF) {
+        memcpy(buf, mantissa ? "nan" : "inf", 3);
+        return buf + 3;
+    }
+    if (exponent == 0 && mantissa == 0) {
+        *buf = '0';
+        return buf + 1;
+    }
+
+    uint64_t output;
+    int exp10;
+    ryu::shortest(mantissa, exponent, output, exp10);
+
+    char digits[MAX_INT_CHARS];
+    int n = static_cast<int>(writeUnsigned(digits, output) - digits);
+    int sciExp = exp10 + n - 1;
+
+    // Fixed or scientific, whichever is shorter (ties go to fixed), like to_chars
+    int absSci = sciExp < 0 ? -sciExp : sciExp;
+    int sciLen = n + (n > 1) + 2 + (absSci >= 100 ? 3 : 2);
+    int fixedLen = exp10 >= 0 ? n + exp10 : (n + exp10 > 0 ? n + 1 : 2 - exp10);
+    if (fixedLen <= sciLen) {
+        if (exp10 > 0) {
+            // 1234000: an integer. to_chars prints its EXACT digits here (same length, closer to
+            // the value), e.g. 450193708988009611264 rather than 450193708988009600000.
+            // Fixed is only chosen below 10^22, so the value fits in 128 bits.
+            uint64_t m2 = exponent ? (1ull << 52) | mantissa : mantissa;
+            int e2 = static_cast<int>(exponent ? exponent : 1) - 1075;
+            ryu::u128 v = e2 >= 0 ? static_cast<ryu::u128>(m2) << e2 : m2 >> -e2;
+            char rev[40];
+            int len = 0;
+            for (; v >= 10; v /= 10) rev[len++] = static_cast<char>('0' + static_cast<int>(v % 10));
+            rev[len++] = static_cast<char>('0' + static_cast<int>(v));
+            for (int k = 0; k < len; k++) buf[k] = rev[len - 1 - k];
+            return buf + len;
+        }
+        if (exp10 == 0) { // 1234
+            memcpy(buf, digits, n);
+            return buf + n;
+        }
+        int intDigits = n + exp10;
+        if (intDigits > 0) { // 12.34
+            memcpy(buf, digits, intDigits);
+            buf[intDigits] = '.';
+            memcpy(buf + intDigits + 1, digits + intDigits, n - intDigits);
+            return buf + n + 1;
+        }
+        buf[0] = '0'; // 0.001234
+        buf[1] = '.';
+        memset(buf + 2, '0', -intDigits);
+        memcpy(buf + 2 - intDigits, digits, n);
+        return buf + 2 - intDigits + n;
+    }
+    // 1.234e+56
+    char* p = buf;
+    *p++ = digits[0];
+    if (n > 1) {
+        *p++ = '.';
+        memcpy(p, digits + 1, n - 1);
+        p += n - 1;
+    }
+    *p++ = 'e';
+    *p++ = sciExp < 0 ? '-' : '+';
+    if (absSci >= 100) {
+        *p++ = static_cast<char>('0' + absSci / 100);
+        absSci %= 100;
+    }
+    memcpy(p, DIGIT_PAIRS + 2 * absSci, 2);
+    return p + 2;
+}
+
+/* Convenience: one allocation at most (none for short results thanks to the small-string buffer) */
+template <class T>
+string fastToString(T value) {
+    char buf[MAX_DOUBLE_CHARS];
+    char* end;
+    if constexpr (is_floating_point_v<T>) end = writeDouble(buf, static_cast<double>(value));
+    else end = writeInt(buf, value);
+    return string(buf, end);
+}
+
+/* SELF-TEST against std::to_chars */
+bool selfTest() {
+    char a[64], b[64];
+    int failures = 0;
+    auto checkDouble = [&](double d) {
+        size_t la = static_cast<size_t>(writeDouble(a, d) - a);
+        size_t lb = static_cast<size_t>(to_chars(b, b + sizeof b, d).ptr - b);
+        if (la != lb || memcmp(a, b, la) != 0) {
+            if (failures++ < 5) cout << "  mismatch: " << string(a, la) << " vs " << string(b, lb) << "\n";
+        }
+    };
+    auto checkInt = [&](int64_t v) {
+        size_t la = static_cast<size_t>(writeInt(a, v) - a);
+        size_t lb = static_cast<size_t>(to_chars(b, b + sizeof b, v).ptr - b);
+        if (la != lb || memcmp(a, b, la) != 0) failures++;
+    };
+
+    for (double d : {0.0, -0.0, 1.0, 0.1, 0.3, 0.1 + 0.2, 1e21, 1e22, 1e-7, 123456.0, 5e-324, 2.2250738585072014e-308,
+                     1.7976931348623157e308, 9007199254740993.0, 1.0 / 3, 100.0, 0.001})
+        checkDouble(d);
+    for (int64_t v : {INT64_MIN, INT64_MAX, int64_t(0), int64_t(-1), int64_t(9), int64_t(10), int64_t(99),
+                      int64_t(100)})
+        checkInt(v);
+    checkInt(0);
+    for (int p = 0; p < 19; p++) {
+        checkInt(static_cast<int64_t>(POW10[p]));
+        checkInt(static_cast<int64_t>(POW10[p]) - 1);
+    }
+
+    mt19937_64 rng(48);
+    const int randomCount = 3000000;
+    for (int i = 0; i < randomCount; i++) {
+        uint64_t bits = rng();
+        double d;
+        memcpy(&d, &bits, sizeof d);
+        if (d != d) continue; // NaN payload/sign printing is not interesting
+        checkDouble(d);
+        checkDouble(static_cast<double>(static_cast<int64_t>(rng() % 2000000) - 1000000) / 1000); // "nice" numbers
+        checkInt(static_cast<int64_t>(bits) >> (rng() % 64));
+    }
+    cout << "Self-test vs to_chars: " << randomCount << " random doubles/ints, " << failures << " failures\n";
+    return failures == 0;
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    const int n = 5000000;
+    mt19937_64 rng(2);
+    vector<int64_t> ints(n);
+    vector<double> doubles(n);
+    for (int i = 0; i < n; i++) {
+        ints[i] = static_cast<int64_t>(rng()) >> (rng() % 60);
+        doubles[i] = static_cast<double>(rng() % 100000000) / 997.0;
+    }
+
+    size_t total = 0;
+    char buf[64];
+    double tToString = timeMs([&] {
+        for (int64_t v : ints) total += to_string(v).size();
+    });
+    double tToChars = timeMs([&] {
+        for (int64_t v : ints) total += static_cast<size_t>(to_chars(buf, buf + sizeof buf, v).ptr - buf);
+    });
+    double tWrite = timeMs([&] {
+        for (int64_t v : ints) total += static_cast<size_t>(writeInt(buf, v) - buf);
+    });
+    cout << "\nBenchmark (" << n << " values):\n  int64:  std::to_string " << tToString << " ms, to_chars "
+         << tToChars << " ms, writeInt " << tWrite << " ms (" << tToString / tWrite << "x)\n";
+
+    // Building one long text (a CSV row, a log line): to_string creates a temporary string
+    // for every number (heap-allocated past 15 characters) and copies it; writeInt
+    // formats into a stack buffer that is appended directly
+    string joined;
+    joined.reserve(static_cast<size_t>(n) * (MAX_INT_CHARS + 1));
+    double tJoinToString = timeMs([&] {
+        for (int64_t v : ints) {
+            joined += to_string(v);
+            joined += ',';
+        }
+    });
+    size_t expected = joined.size();
+    joined.clear();
+    double tJoinWrite = timeMs([&] {
+        for (int64_t v : ints) {
+            joined.append(buf, writeInt(buf, v));
+            joined += ',';
+        }
+    });
+    cout << "          joining into one string: += to_string " << tJoinToString << " ms, writeInt + append "
+         << tJoinWrite << " ms (" << tJoinToString / tJoinWrite << "x" << (joined.size() == expected ? "" : ", MISMATCH")
+         << ")\n";
+
+    tToString = timeMs([&] {
+        for (double d : doubles) total += to_string(d).size();
+    });
+    double tPrintf = timeMs([&] {
+        for (double d : doubles) total += static_cast<size_t>(snprintf(buf, sizeof buf, "%.17g", d));
+    });
+    tToChars = timeMs([&] {
+        for (double d : doubles) total += static_cast<size_t>(to_chars(buf, buf + sizeof buf, d).ptr - buf);
+    });
+    tWrite = timeMs([&] {
+        for (double d : doubles) total += static_cast<size_t>(writeDouble(buf, d) - buf);
+    });
+    cout << "  double: std::to_string (6 decimals, lossy) " << tToString << " ms, snprintf %.17g " << tPrintf
+         << " ms, to_chars " << tToChars << " ms, writeDouble " << tWrite << " ms\n"
+         << "  (checksum " << total << ")\n";
+}
+
+int main() {
+    int x = 42;
+    string s = fastToString(x);
+    cout << "fastToString(42) = " << s << ", fastToString(0.1 + 0.2) = " << fastToString(0.1 + 0.2)
+         << ", std::to_string(0.1 + 0.2) = " << to_string(0.1 + 0.2) << "\n";
+    char buf[MAX_DOUBLE_CHARS];
+    cout << "writeDouble(1e-7) = " << string(buf, writeDouble(buf, 1e-7)) << ", writeDouble(6.02214076e23) = "
+         << string(buf, writeDouble(buf, 6.02214076e23)) << "\n";
+
+    if (!selfTest()) return 1;
+    benchmark();
+    return 0;
+}
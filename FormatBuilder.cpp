@@ -0,0 +1,290 @@
+/*
+==================================== FORMAT BUILDER =====================================
+
+An allocation-free replacement for building strings with ostringstream, as done in
+StringStreams.cpp:
+
+    formattedSentence():  ss << "Name: " << name << ", Age: " << age;  cout << ss.str();
+    numberToString():     ss << x;  string s = ss.str();
+    vectorToString():     for (int x : v) ss << x << " ";
+
+ostringstream allocates its buffer, formats numbers through the locale machinery, and
+.str() then copies everything into yet another std::string.
+
+StringBuilder<N>
+  - Keeps the first N characters in an array INSIDE the object (on the stack for a
+    local variable). Only if the text grows beyond that does it move to the heap,
+    doubling its capacity each time. Typical log and report lines never allocate.
+  - Integers and floating-point numbers are written with std::to_chars straight into
+    the buffer: no locale, no temporary strings. Doubles use the shortest text that
+    reads back to the same value; Fixed{x, digits} gives a fixed number of decimals.
+  - view() returns a string_view of the result (no copy); str() makes a std::string
+    only when one is really needed.
+  - Streams like ostringstream: builder << "Age: " << 21;
+
+format(builder, "Name: {}, Age: {}", name, age)
+  - "{}" is replaced by the next argument; "{{" and "}}" are literal braces.
+  - With C++20 the format string is checked AT COMPILE TIME: a wrong number of "{}"
+    or a stray brace is a compile error (the checking constructor is consteval).
+    With C++17 the same check runs when format() is called and throws logic_error.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <memory>
+#include <cstring>
+#include <new>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <chrono>
+using namespace std;
+
+/* ALLOCATION COUNTER (to show the builder really does not allocate) */
+static size_t allocationCount = 0;
+
+void* operator new(size_t n) {
+    allocationCount++;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+/* BUILDER */
+
+struct Fixed {
+    double value;
+    int digits;
+};
+
+template <size_t N = 256>
+class StringBuilder {
+    char inlineBuf[N];
+    unique_ptr<char[]> heap; // used once the text outgrows inlineBuf
+    char* buf = inlineBuf;
+    size_t len = 0, cap = N;
+
+    void grow(size_t needed) {
+        size_t newCap = cap * 2;
+        while (newCap < needed) newCap *= 2;
+        unique_ptr<char[]> bigger(new char[newCap]);
+        memcpy(bigger.get(), buf, len);
+        heap = move(bigger);
+        buf = heap.get();
+        cap = newCap;
+    }
+
+    /* Make room for at least n more characters and return where they go */
+    char* reserveTail(size_t n) {
+        if (len + n > cap) grow(len + n);
+        return buf + len;
+    }
+
+public:
+    StringBuilder() = default;
+    StringBuilder(const StringBuilder&) = delete; // buf may point into this object
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    StringBuilder& append(string_view s) {
+        memcpy(reserveTail(s.size()), s.data(), s.size());
+        len += s.size();
+        return *this;
+    }
+
+    StringBuilder& append(char c) {
+        *reserveTail(1) = c;
+        len++;
+        return *this;
+    }
+
+    template <class T, enable_if_t<is_integral_v<T> && !is_same_v<T, bool> && !is_same_v<T, char>, int> = 0>
+    StringBuilder& append(T value) {
+        char tmp[24]; // enough for any 64-bit integer with sign
+        return append(string_view(tmp, static_cast<size_t>(to_chars(tmp, tmp + sizeof tmp, value).ptr - tmp)));
+    }
+
+    template <class T, enable_if_t<is_floating_point_v<T>, int> = 0>
+    StringBuilder& append(T value) {
+        char tmp[32]; // the shortest round-trip form of a double needs at most 24
+        return append(string_view(tmp, static_cast<size_t>(to_chars(tmp, tmp + sizeof tmp, value).ptr - tmp)));
+    }
+
+    StringBuilder& append(Fixed f) {
+        while (true) {
+            char* p = reserveTail(32 + static_cast<size_t>(f.digits));
+            to_chars_result r = to_chars(p, buf + cap, f.value, chars_format::fixed, f.digits);
+            if (r.ec == errc()) {
+                len = static_cast<size_t>(r.ptr - buf);
+                return *this;
+            }
+            grow(cap + 1); // huge values (1e300 with fixed notation) need more room
+        }
+    }
+
+    StringBuilder& append(bool b) { return append(string_view(b ? "true" : "false")); }
+    StringBuilder& append(const char* s) { return append(string_view(s)); }
+    StringBuilder& append(const string& s) { return append(string_view(s)); }
+
+    template <class T>
+    StringBuilder& operator<<(const T& value) { return append(value); }
+
+    string_view view() const { return string_view(buf, len); }
+    string str() const { return string(buf, len); }
+    size_t size() const { return len; }
+    bool onHeap() const { return buf != inlineBuf; }
+    void clear() { len = 0; } // keeps any heap buffer for reuse
+};
+
+/* FORMAT STRINGS */
+
+/* Number of "{}" placeholders, or -1 if the string has an unmatched brace */
+constexpr int countPlaceholders(string_view f) {
+    int count = 0;
+    for (size_t i = 0; i < f.size(); i++) {
+        if (f[i] == '{') {
+            if (i + 1 < f.size() && f[i + 1] == '{') i++;
+            else if (i + 1 < f.size() && f[i + 1] == '}') count++, i++;
+            else return -1;
+        } else if (f[i] == '}') {
+            if (i + 1 < f.size() && f[i + 1] == '}') i++;
+            else return -1;
+        }
+    }
+    return count;
+}
+
+#if __cpp_consteval
+#define FORMAT_CHECK consteval
+void formatStringError(const char*); // not constexpr: calling it during consteval is a compile error
+#else
+#define FORMAT_CHECK constexpr
+[[noreturn]] inline void formatStringError(const char* what) { throw logic_error(what); }
+#endif
+
+template <class... Args>
+struct FormatString {
+    string_view text;
+
+    template <size_t L>
+    FORMAT_CHECK FormatString(const char (&s)[L]) : text(s, L - 1) {
+        int n = countPlaceholders(text);
+        if (n < 0) formatStringError("format string has an unmatched '{' or '}'");
+        if (n != static_cast<int>(sizeof...(Args))) formatStringError("number of {} does not match the arguments");
+    }
+};
+
+/* Stops Args from being deduced from the format string, so FormatString<Args...> is built from the literal */
+template <class T>
+struct NonDeduced {
+    using type = T;
+};
+
+/* Copies literal text (unescaping "{{" and "}}") up to the next "{}" and moves past it */
+template <size_t N>
+void appendLiteral(StringBuilder<N>& out, string_view f, size_t& pos) {
+    while (pos < f.size()) {
+        char c = f[pos];
+        if (c == '{' && f[pos + 1] == '}') {
+            pos += 2;
+            return;
+        }
+        out.append(c);
+        pos += (c == '{' || c == '}') ? 2 : 1;
+    }
+}
+
+template <size_t N, class... Args>
+StringBuilder<N>& format(StringBuilder<N>& out, FormatString<typename NonDeduced<Args>::type...> fmt,
+                         const Args&... args) {
+    size_t pos = 0;
+    ((appendLiteral(out, fmt.text, pos), out.append(args)), ...);
+    appendLiteral(out, fmt.text, pos); // text after the last placeholder
+    return out;
+}
+
+/* DEMOS (the StringStreams.cpp examples) */
+void formattedSentence() {
+    StringBuilder<> sb;
+    string name = "Sapto";
+    int age = 21;
+    format(sb, "Name: {}, Age: {}", name, age);
+    cout << sb.view() << "\n";
+    // format(sb, "Name: {}, Age: {}", name);   // C++20: does not compile (1 argument, 2 placeholders)
+}
+
+void numberToString() {
+    StringBuilder<32> sb;
+    sb << 100 << " " << -7LL << " " << 0.1 << " " << 1e21 << " " << Fixed{3.14159, 2};
+    cout << sb.view() << "\n";
+}
+
+void vectorToString() {
+    vector<int> v = {1, 2, 3, 4};
+    StringBuilder<> sb;
+    for (int x : v) sb << x << ' ';
+    cout << sb.view() << "\n";
+}
+
+void spillDemo() {
+    StringBuilder<16> sb;
+    format(sb, "{{tiny}} {}", 1);
+    cout << sb.view() << " (on heap: " << sb.onHeap() << ")\n";
+    sb << " and now a line long enough to spill past 16 bytes";
+    cout << sb.view() << " (on heap: " << sb.onHeap() << ")\n";
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    const int n = 1000000;
+    string name = "Sapto";
+    size_t total1 = 0, total2 = 0;
+
+    size_t before = allocationCount;
+    double tStream = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            ostringstream ss;
+            ss << "user=" << name << " id=" << i << " load=" << i * 0.001 << " ok=" << (i % 3 == 0);
+            total1 += ss.str().size();
+        }
+    });
+    size_t streamAllocs = allocationCount - before;
+
+    before = allocationCount;
+    double tBuilder = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            StringBuilder<> sb;
+            format(sb, "user={} id={} load={} ok={}", name, i, i * 0.001, static_cast<int>(i % 3 == 0));
+            total2 += sb.size();
+        }
+    });
+    size_t builderAllocs = allocationCount - before;
+
+    cout << "\nBenchmark (" << n << " log lines):\n"
+         << "  ostringstream + str(): " << tStream << " ms, " << streamAllocs << " allocations\n"
+         << "  StringBuilder format:  " << tBuilder << " ms, " << builderAllocs << " allocations"
+         << " (" << total1 << " vs " << total2 << " characters; ostringstream rounds doubles to 6 digits)\n";
+}
+
+int main() {
+    formattedSentence();
+    numberToString();
+    vectorToString();
+    spillDemo();
+    benchmark();
+    return 0;
+}
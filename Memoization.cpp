@@ -0,0 +1,293 @@
+/*
+====================================== MEMOIZATION ======================================
+
+A reusable memoization wrapper for pure recursive functions.
+
+fib() in Recursion.cpp recomputes fib(n-2) inside fib(n-1) and so on, exponentially
+often. Any pure function (same input -> same output, no side effects) can instead
+remember its results: compute once, look up afterwards.
+
+Memoized<Key, Value, Store>
+  - Wraps any callable f(self, key). 'self' is the memoized function, so recursive
+    calls go through the cache too.
+  - Pluggable result store:
+      DenseStore  - vector indexed directly by a small non-negative integer key.
+      HashStore   - open addressing (linear probing, power-of-two table) for any
+                    hashable key, e.g. pair<int,int>.
+      LruStore    - bounded: keeps only the most recently used 'capacity' results.
+  - Thread safety: lookups take a shared (reader) lock, inserts an exclusive lock.
+    The function itself runs with no lock held, so recursion cannot deadlock and
+    concurrent readers never block each other. (LruStore reorders on every hit, so
+    its lookups need the exclusive lock; it says so via 'lookupMutates'.)
+  - hits() / misses() counters (atomic) to measure what the cache buys.
+
+If two threads miss the same key at once, both compute it and the first insert wins;
+for a pure function that only costs a little duplicate work.
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+/* STORES */
+
+/* Keys 0..N-1 index a vector directly; grows on demand */
+template <class Key, class Value>
+class DenseStore {
+    vector<Value> values;
+    vector<bool> present;
+
+public:
+    static constexpr bool lookupMutates = false;
+
+    const Value* find(const Key& k) const {
+        size_t i = static_cast<size_t>(k);
+        return i < present.size() && present[i] ? &values[i] : nullptr;
+    }
+
+    void insert(const Key& k, const Value& v) {
+        size_t i = static_cast<size_t>(k);
+        if (i >= values.size()) {
+            values.resize(max(i + 1, values.size() * 2));
+            present.resize(values.size(), false);
+        }
+        values[i] = v;
+        present[i] = true;
+    }
+
+    size_t size() const { return count(present.begin(), present.end(), true); }
+};
+
+/* Open addressing with linear probing; rehashes above 70% load */
+template <class Key, class Value, class Hash = hash<Key>>
+class HashStore {
+    struct Slot {
+        Key key;
+        Value value;
+        bool used = false;
+    };
+    vector<Slot> slots = vector<Slot>(16);
+    unsigned shift = 64 - 4; // 64 - log2(slots.size())
+    size_t count = 0;
+    Hash hasher;
+
+    size_t indexOf(const Key& k) const {
+        size_t mask = slots.size() - 1;
+        // Fibonacci hashing: the top bits of the product depend on every bit of the hash,
+        // which scrambles weak hashes (e.g. PairHash below) across the whole table
+        size_t i = static_cast<size_t>(static_cast<uint64_t>(hasher(k)) * 0x9E3779B97F4A7C15ull >> shift);
+        while (slots[i].used && !(slots[i].key == k)) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        vector<Slot> old = move(slots);
+        slots = vector<Slot>(old.size() * 2);
+        shift--;
+        count = 0;
+        for (Slot& s : old)
+            if (s.used) insert(s.key, s.value);
+    }
+
+public:
+    static constexpr bool lookupMutates = false;
+
+    const Value* find(const Key& k) const {
+        const Slot& s = slots[indexOf(k)];
+        return s.used ? &s.value : nullptr;
+    }
+
+    void insert(const Key& k, const Value& v) {
+        if ((count + 1) * 10 > slots.size() * 7) grow();
+        Slot& s = slots[indexOf(k)];
+        if (!s.used) count++;
+        s.key = k;
+        s.value = v;
+        s.used = true;
+    }
+
+    size_t size() const { return count; }
+};
+
+/* Keeps at most 'capacity' entries, evicting the least recently used */
+template <class Key, class Value, class Hash = hash<Key>>
+class LruStore {
+    using Entry = pair<Key, Value>;
+    list<Entry> order; // front = most recently used
+    unordered_map<Key, typename list<Entry>::iterator, Hash> index;
+    size_t capacity;
+
+public:
+    static constexpr bool lookupMutates = true;
+
+    explicit LruStore(size_t cap = 1024) : capacity(cap) {}
+
+    const Value* find(const Key& k) {
+        auto it = index.find(k);
+        if (it == index.end()) return nullptr;
+        order.splice(order.begin(), order, it->second);
+        return &it->second->second;
+    }
+
+    void insert(const Key& k, const Value& v) {
+        auto it = index.find(k);
+        if (it != index.end()) {
+            it->second->second = v;
+            order.splice(order.begin(), order, it->second);
+            return;
+        }
+        order.emplace_front(k, v);
+        index[k] = order.begin();
+        if (order.size() > capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+    }
+
+    size_t size() const { return order.size(); }
+};
+
+/* MEMOIZING WRAPPER */
+template <class Key, class Value, class Store>
+class Memoized {
+    function<Value(Memoized&, const Key&)> fn;
+    Store store;
+    mutable shared_mutex lock;
+    atomic<uint64_t> hitCount{0}, missCount{0};
+
+    bool lookup(const Key& k, Value& out) {
+        if constexpr (Store::lookupMutates) {
+            unique_lock<shared_mutex> guard(lock);
+            if (const Value* v = store.find(k)) {
+                out = *v;
+                return true;
+            }
+        } else {
+            shared_lock<shared_mutex> guard(lock);
+            if (const Value* v = store.find(k)) {
+                out = *v;
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    template <class F>
+    explicit Memoized(F f, Store s = Store()) : fn(move(f)), store(move(s)) {}
+
+    Value operator()(const Key& k) {
+        Value v;
+        if (lookup(k, v)) {
+            hitCount.fetch_add(1, memory_order_relaxed);
+            return v;
+        }
+        missCount.fetch_add(1, memory_order_relaxed);
+        v = fn(*this, k); // no lock held while computing
+        unique_lock<shared_mutex> guard(lock);
+        store.insert(k, v);
+        return v;
+    }
+
+    uint64_t hits() const { return hitCount.load(); }
+    uint64_t misses() const { return missCount.load(); }
+    size_t cached() const {
+        shared_lock<shared_mutex> guard(lock);
+        return store.size();
+    }
+};
+
+/* Hash for pair keys such as (n, k) */
+struct PairHash {
+    size_t operator()(const pair<int, int>& p) const {
+        return hash<long long>()((static_cast<long long>(p.first) << 32) ^ static_cast<unsigned>(p.second));
+    }
+};
+
+/* EXAMPLES */
+
+/* fib as in Recursion.cpp, uncached, for comparison */
+uint64_t fibPlain(int n) {
+    if (n < 2) return 1;
+    return fibPlain(n - 2) + fibPlain(n - 1);
+}
+
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void fibExample() {
+    Memoized<int, uint64_t, DenseStore<int, uint64_t>> fib([](auto& self, const int& n) -> uint64_t {
+        if (n < 2) return 1;
+        return self(n - 2) + self(n - 1);
+    });
+
+    uint64_t plain = 0, memo = 0;
+    double tPlain = timeMs([&] { plain = fibPlain(40); });
+    double tMemo = timeMs([&] { memo = fib(40); });
+    cout << "fib(40): plain " << plain << " in " << tPlain << " ms, memoized " << memo << " in " << tMemo
+         << " ms (hits " << fib.hits() << ", misses " << fib.misses() << ")\n";
+    cout << "fib(90) memoized = " << fib(90) << " (hits " << fib.hits() << ", misses " << fib.misses() << ")\n";
+}
+
+/* Binomial coefficients C(n, k) = C(n-1, k-1) + C(n-1, k): two-integer key -> HashStore */
+void binomialExample() {
+    using Key = pair<int, int>;
+    Memoized<Key, uint64_t, HashStore<Key, uint64_t, PairHash>> binom([](auto& self, const Key& nk) -> uint64_t {
+        auto [n, k] = nk;
+        if (k == 0 || k == n) return 1;
+        return self({n - 1, k - 1}) + self({n - 1, k});
+    });
+    cout << "C(60, 30) = " << binom({60, 30}) << " (hits " << binom.hits() << ", misses " << binom.misses()
+         << ", cached " << binom.cached() << ")\n";
+}
+
+/* Collatz chain lengths with a bounded LRU, shared by several reader threads */
+void collatzExample() {
+    using Store = LruStore<uint64_t, int>;
+    Memoized<uint64_t, int, Store> steps(
+        [](auto& self, const uint64_t& n) -> int {
+            if (n == 1) return 0;
+            return 1 + self(n % 2 ? 3 * n + 1 : n / 2);
+        },
+        Store(1 << 16));
+
+    const int threads = 4;
+    vector<int> best(threads, 0);
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            for (uint64_t n = 1 + t; n < 200000; n += threads) best[t] = max(best[t], steps(n));
+        });
+    }
+    for (auto& th : pool) th.join();
+    cout << "Longest Collatz chain below 200000: " << *max_element(best.begin(), best.end())
+         << " steps (hits " << steps.hits() << ", misses " << steps.misses() << ", LRU holds "
+         << steps.cached() << ")\n";
+}
+
+int main() {
+    fibExample();
+    binomialExample();
+    collatzExample();
+    return 0;
+}
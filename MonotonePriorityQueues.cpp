@@ -0,0 +1,209 @@
+/*
+============================== MONOTONE PRIORITY QUEUES ================================
+
+When are comparison heaps overkill?
+  CustomComparatorForPriorityQueue.cpp uses a binary heap: O(log n) per push/pop.
+  Two extra facts about a workload let us do better:
+    1. Priorities are small non-negative integers.
+    2. Pops are monotone: nothing pushed is ever smaller than the last popped priority
+       (Dijkstra's algorithm, timer expiry, event simulation...).
+
+This file implements two queues with the same push / top / pop interface as
+priority_queue<Item, vector<Item>, CompareItem> (lowest priority value first):
+
+- RadixHeap
+    33 buckets. Bucket i holds keys whose highest bit differing from the last popped
+    key is bit i-1 (bucket 0 = equal to it). When bucket 0 runs dry, the first
+    non-empty bucket is redistributed into lower buckets. Every item can only move
+    down, so each one is touched O(log C) times in total -> amortized O(1)-ish
+    for bounded keys, with no comparisons between Items at all.
+
+- BucketQueue (Dial's algorithm)
+    If every push lies within [lastPopped, lastPopped + maxSpread], a ring of
+    maxSpread + 1 buckets indexed by (priority % ring size) is enough.
+    push is O(1); pop is O(1) amortized (the cursor only moves forward).
+
+Both throw logic_error if the monotone contract is broken, rather than silently
+returning items out of order.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <array>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* RADIX HEAP */
+class RadixHeap {
+    array<vector<Item>, 33> buckets;
+    uint32_t last = 0;  // priority of the most recently popped item (lower bound for pushes)
+    size_t count = 0;
+
+    static int bucketFor(uint32_t key, uint32_t last) {
+        if (key == last) return 0;
+        return 32 - __builtin_clz(key ^ last); // 1 + index of highest differing bit
+    }
+
+    /* Make sure bucket 0 holds the minimum, redistributing the first non-empty bucket */
+    void pull() {
+        if (!buckets[0].empty()) return;
+        int i = 1;
+        while (buckets[i].empty()) i++;
+
+        uint32_t newLast = UINT32_MAX;
+        for (const Item& it : buckets[i]) newLast = min(newLast, static_cast<uint32_t>(it.priority));
+        last = newLast;
+
+        vector<Item> moving;
+        moving.swap(buckets[i]);
+        for (Item& it : moving) buckets[bucketFor(it.priority, last)].push_back(move(it));
+        moving.clear();
+        moving.swap(buckets[i]); // keep the capacity around for reuse
+    }
+
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(Item item) {
+        if (item.priority < 0 || static_cast<uint32_t>(item.priority) < last)
+            throw logic_error("RadixHeap: priority below last popped value");
+        int b = bucketFor(item.priority, last);
+        buckets[b].push_back(move(item));
+        count++;
+    }
+
+    const Item& top() {
+        pull();
+        return buckets[0].back();
+    }
+
+    void pop() {
+        pull();
+        buckets[0].pop_back();
+        count--;
+    }
+};
+
+/* BUCKET QUEUE (Dial) */
+class BucketQueue {
+    vector<vector<Item>> ring;
+    int current = 0;  // priority the cursor is sitting on
+    size_t count = 0;
+
+    vector<Item>& slot(int priority) { return ring[priority % ring.size()]; }
+
+    void advance() {
+        while (slot(current).empty()) current++;
+    }
+
+public:
+    /* maxSpread: largest (pushed priority - last popped priority) the workload can produce */
+    explicit BucketQueue(int maxSpread) : ring(maxSpread + 1) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(Item item) {
+        if (item.priority < current || item.priority - current >= static_cast<int>(ring.size()))
+            throw logic_error("BucketQueue: priority outside [current, current + maxSpread]");
+        slot(item.priority).push_back(move(item));
+        count++;
+    }
+
+    const Item& top() {
+        advance();
+        return slot(current).back();
+    }
+
+    void pop() {
+        advance();
+        slot(current).pop_back();
+        count--;
+    }
+};
+
+/* DEMO */
+template <class Queue>
+void drain(const string& name, Queue& q) {
+    q.push(Item(3, "Whey Protein"));
+    q.push(Item(1, "Eggs"));
+    q.push(Item(5, "Dumbbells"));
+    q.push(Item(2, "Cables"));
+
+    cout << name << " - items in order of priority:\n";
+    while (!q.empty()) {
+        const Item& i = q.top();
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+        q.pop();
+    }
+}
+
+/* BENCHMARK: Dijkstra-like monotone workload
+   Keep N items queued; pop the minimum and push a successor at
+   popped priority + random step in [1, maxStep]. */
+template <class Queue>
+double run(Queue& q, size_t n, size_t ops, int maxStep, long long& checksum) {
+    mt19937 rng(7);
+    uniform_int_distribution<int> step(1, maxStep);
+    for (size_t i = 0; i < n; i++) q.push(Item(step(rng), "task"));
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; i++) {
+        int p = q.top().priority;
+        q.pop();
+        checksum += p;
+        q.push(Item(p + step(rng), "task"));
+    }
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark(size_t n, size_t ops, int maxStep) {
+    long long c1 = 0, c2 = 0, c3 = 0;
+    priority_queue<Item, vector<Item>, CompareItem> heap;
+    RadixHeap radix;
+    BucketQueue buckets(maxStep);
+
+    double tHeap = run(heap, n, ops, maxStep, c1);
+    double tRadix = run(radix, n, ops, maxStep, c2);
+    double tBucket = run(buckets, n, ops, maxStep, c3);
+
+    cout << "\nBenchmark (" << n << " queued, " << ops << " pop+push, step <= " << maxStep << "):\n"
+         << "  priority_queue<Item>: " << tHeap << " ms\n"
+         << "  RadixHeap:            " << tRadix << " ms\n"
+         << "  BucketQueue:          " << tBucket << " ms\n"
+         << "  checksums match: " << (c1 == c2 && c2 == c3 ? "yes" : "NO") << endl;
+}
+
+int main() {
+    RadixHeap radix;
+    drain("RadixHeap", radix);
+    BucketQueue buckets(10);
+    drain("BucketQueue", buckets);
+
+    benchmark(1000000, 5000000, 1000);
+    return 0;
+}
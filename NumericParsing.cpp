@@ -0,0 +1,251 @@
+/*
+=================================== NUMERIC PARSING =====================================
+
+A fast replacement for parsing numbers with stringstream, as done in StringStreams.cpp:
+
+    stringToNumber():  stringstream(s) >> x;
+    extractValues():   stringstream ss(s); ss >> a >> b >> c;
+
+Every stringstream allocates its buffer, copies the string into it, consults the
+global locale and goes through several virtual calls per value. And when the parse
+fails, all you learn is that failbit is set.
+
+std::from_chars (C++17, <charconv>) does only the conversion: no locale, no
+allocation, no exceptions. It reports exactly where parsing stopped and why.
+
+This file adds a small typed API on top of it:
+
+- parseNumber<T>(text)       -> ParseResult<T> { value, error, position }
+                                 Surrounding whitespace and a leading '+' are
+                                 accepted, like >>; anything else left over is an error.
+- parseNumberOrThrow<T>(text) -> T, or throws invalid_argument / out_of_range
+                                 (the same exceptions stoi/stod use).
+- parseAll<T>(text, out)      -> appends every whitespace-separated number in text to
+                                 a vector<T> in one pass; stops at the first bad token
+                                 and reports its offset.
+
+T can be any integer type, float or double.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <chrono>
+#include <random>
+#include <cstdint>
+using namespace std;
+
+/* RESULT AND ERROR TYPES */
+
+enum class ParseError { None, Empty, NotANumber, OutOfRange, TrailingCharacters };
+
+const char* describe(ParseError e) {
+    switch (e) {
+        case ParseError::None: return "ok";
+        case ParseError::Empty: return "empty input";
+        case ParseError::NotANumber: return "not a number";
+        case ParseError::OutOfRange: return "out of range";
+        case ParseError::TrailingCharacters: return "trailing characters";
+    }
+    return "unknown";
+}
+
+template <class T>
+struct ParseResult {
+    T value{};
+    ParseError error = ParseError::None;
+    size_t position = 0; // offset of the first character not consumed (or of the error)
+
+    explicit operator bool() const { return error == ParseError::None; }
+};
+
+/* SINGLE VALUES */
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* Converts the number starting at text[pos]; does not look past it */
+template <class T>
+static ParseResult<T> parsePrefix(string_view text, size_t pos) {
+    static_assert(is_arithmetic_v<T> && !is_same_v<T, bool>, "parseNumber needs an integer or floating-point type");
+    ParseResult<T> r;
+    const char* first = text.data() + pos;
+    const char* last = text.data() + text.size();
+    if (first == last) {
+        r.error = ParseError::Empty;
+        r.position = pos;
+        return r;
+    }
+    // from_chars rejects a leading '+', stream >> accepts it
+    if (*first == '+' && last - first > 1 && first[1] != '-' && first[1] != '+') first++;
+
+    from_chars_result res = from_chars(first, last, r.value);
+    r.position = static_cast<size_t>(res.ptr - text.data());
+    if (res.ec == errc::invalid_argument) {
+        r.error = ParseError::NotANumber;
+        r.position = pos;
+    } else if (res.ec == errc::result_out_of_range) {
+        r.error = ParseError::OutOfRange;
+    }
+    return r;
+}
+
+template <class T>
+ParseResult<T> parseNumber(string_view text) {
+    size_t pos = 0;
+    while (pos < text.size() && isSpace(text[pos])) pos++;
+    ParseResult<T> r = parsePrefix<T>(text, pos);
+    if (!r) return r;
+    size_t rest = r.position;
+    while (rest < text.size() && isSpace(text[rest])) rest++;
+    if (rest != text.size()) r.error = ParseError::TrailingCharacters;
+    return r;
+}
+
+template <class T>
+T parseNumberOrThrow(string_view text) {
+    ParseResult<T> r = parseNumber<T>(text);
+    if (r.error == ParseError::OutOfRange) throw out_of_range("parseNumber: '" + string(text) + "' is out of range");
+    if (!r)
+        throw invalid_argument("parseNumber: '" + string(text) + "': " + describe(r.error) + " at offset " +
+                               to_string(r.position));
+    return r.value;
+}
+
+/* BULK: whitespace-separated buffer -> vector */
+
+struct BulkResult {
+    size_t parsed = 0;              // numbers appended to the vector
+    ParseError error = ParseError::None;
+    size_t position = 0;            // offset of the offending token
+
+    explicit operator bool() const { return error == ParseError::None; }
+};
+
+template <class T>
+BulkResult parseAll(string_view text, vector<T>& out) {
+    BulkResult br;
+    // A guess that avoids most regrowth for typical data. Grow at least geometrically, so that
+    // appending chunk after chunk into one vector stays amortized O(1) per number.
+    size_t needed = out.size() + text.size() / 8;
+    if (out.capacity() < needed) out.reserve(max(out.capacity() * 2, needed));
+    size_t pos = 0, n = text.size();
+    while (true) {
+        while (pos < n && isSpace(text[pos])) pos++;
+        if (pos == n) return br;
+        ParseResult<T> r = parsePrefix<T>(text, pos);
+        if (r && r.position < n && !isSpace(text[r.position])) r.error = ParseError::TrailingCharacters;
+        if (!r) {
+            br.error = r.error;
+            br.position = pos;
+            return br;
+        }
+        out.push_back(r.value);
+        br.parsed++;
+        pos = r.position;
+    }
+}
+
+/* DEMOS (the StringStreams.cpp examples) */
+void stringToNumberDemo() {
+    int x = parseNumberOrThrow<int>("123");
+    cout << x << "\n";
+
+    for (string_view s : {" 42 ", "+7", "12abc", "", "99999999999", "3.5e2", "-0x1F"}) {
+        ParseResult<int> r = parseNumber<int>(s);
+        cout << "  int    \"" << s << "\" -> ";
+        if (r) cout << r.value << "\n";
+        else cout << describe(r.error) << " at " << r.position << "\n";
+    }
+    ParseResult<double> d = parseNumber<double>("3.5e2");
+    cout << "  double \"3.5e2\" -> " << d.value << "\n";
+
+    try {
+        parseNumberOrThrow<short>("40000");
+    } catch (const out_of_range& e) {
+        cout << "  " << e.what() << "\n";
+    }
+}
+
+void extractValuesDemo() {
+    vector<int> v;
+    BulkResult r = parseAll<int>("25 50 75", v);
+    cout << v[0] << " " << v[1] << " " << v[2] << " (" << r.parsed << " values)\n";
+
+    vector<double> bad;
+    r = parseAll<double>("1.5 2.5 x3 4", bad);
+    cout << "parsed " << r.parsed << " before: " << describe(r.error) << " at offset " << r.position << "\n";
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+template <class T>
+void bulkBenchmark(const string& name, const string& text) {
+    vector<T> a, b;
+    double tStream = timeMs([&] {
+        stringstream ss(text);
+        T x;
+        while (ss >> x) a.push_back(x);
+    });
+    double tFast = timeMs([&] { parseAll<T>(text, b); });
+    cout << "  bulk " << name << ": stringstream >> " << tStream << " ms, parseAll " << tFast << " ms ("
+         << b.size() << " values" << (a == b ? "" : ", MISMATCH") << ")\n";
+}
+
+void benchmark() {
+    mt19937 rng(41);
+    const int n = 2000000;
+
+    // One short string per value, as in stringToNumber()
+    vector<string> tokens;
+    tokens.reserve(n);
+    for (int i = 0; i < n; i++) tokens.push_back(to_string(static_cast<int>(rng() % 2000001) - 1000000));
+    long long s1 = 0, s2 = 0;
+    double tStream = timeMs([&] {
+        for (const string& t : tokens) {
+            int x = 0;
+            stringstream(t) >> x;
+            s1 += x;
+        }
+    });
+    double tFast = timeMs([&] {
+        for (const string& t : tokens) s2 += parseNumber<int>(t).value;
+    });
+    cout << "\nBenchmark:\n  single int: stringstream(s) >> x " << tStream << " ms, parseNumber " << tFast
+         << " ms (" << (s1 == s2 ? "same sum" : "MISMATCH") << ")\n";
+
+    // Whole buffers, as in extractValues()
+    string ints, doubles;
+    for (int i = 0; i < n; i++) {
+        ints += to_string(static_cast<int>(rng()));
+        ints += (i % 16 == 15) ? '\n' : ' ';
+        doubles += to_string((rng() % 1000000) / 997.0);
+        doubles += ' ';
+    }
+    bulkBenchmark<int>("int   ", ints);
+    bulkBenchmark<double>("double", doubles);
+}
+
+int main() {
+    stringToNumberDemo();
+    extractValuesDemo();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+==================================== PAIRING HEAP ======================================
+
+A meldable heap for merging whole priority queues.
+
+Merging two priority_queue<Item, vector<Item>, CompareItem> means popping every Item of
+one and pushing it into the other: O(m log n). A pairing heap (Fredman, Sedgewick,
+Sleator, Tarjan) is a tree where every node keeps a list of children:
+
+  meld(a, b)    O(1)   - the root that loses the comparison becomes a child of the other
+  push          O(1)   - meld with a one-node heap
+  top           O(1)   - the root
+  pop           O(log n) amortized - two-pass pairing of the root's children
+  decrease-key  o(log n) amortized - cut the node's subtree out and meld it with the root
+
+"Decrease-key" here means "make more important", i.e. a lower priority value, using the
+same CompareItem rule as the std::priority_queue version.
+
+Nodes come from a NodePool: big blocks carved into fixed-size slots with a free list,
+so push/pop do not hit the general-purpose allocator. Heaps that share a pool can be
+melded in O(1) because ownership of the nodes simply moves over.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* POOLED NODE ALLOCATOR */
+template <class Node>
+class NodePool {
+    union Slot {
+        Slot* nextFree;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    vector<unique_ptr<Slot[]>> blocks;
+    Slot* freeList = nullptr;
+    size_t used = 0;       // slots handed out from the newest block
+    size_t blockSize = 0;
+
+public:
+    template <class... Args>
+    Node* create(Args&&... args) {
+        Slot* slot;
+        if (freeList) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        } else {
+            if (used == blockSize) {
+                blockSize = blockSize ? blockSize * 2 : 256;
+                blocks.emplace_back(new Slot[blockSize]);
+                used = 0;
+            }
+            slot = &blocks.back()[used++];
+        }
+        return new (slot->storage) Node(forward<Args>(args)...);
+    }
+
+    void destroy(Node* node) {
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+};
+
+/* PAIRING HEAP */
+template <class T, class Compare>
+class PairingHeap {
+public:
+    struct Node {
+        T value;
+        Node* child = nullptr;    // leftmost child
+        Node* sibling = nullptr;  // next sibling to the right
+        Node* prev = nullptr;     // left sibling, or the parent for a leftmost child
+
+        explicit Node(T v) : value(move(v)) {}
+    };
+    using Handle = Node*;
+    using Pool = NodePool<Node>;
+
+private:
+    shared_ptr<Pool> pool;
+    Node* root = nullptr;
+    size_t count = 0;
+    Compare comp;
+    vector<Node*> scratch;  // reused by combine() so pop does not allocate
+
+    /* The loser of the comparison becomes the leftmost child of the winner */
+    Node* link(Node* a, Node* b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (comp(a->value, b->value)) swap(a, b); // a now wins
+        b->prev = a;
+        b->sibling = a->child;
+        if (a->child) a->child->prev = b;
+        a->child = b;
+        a->sibling = nullptr;
+        a->prev = nullptr;
+        return a;
+    }
+
+    /* Standard two-pass pairing: pair up left to right, then fold right to left */
+    Node* combine(Node* first) {
+        if (!first) return nullptr;
+        vector<Node*>& pairs = scratch;
+        pairs.clear();
+        while (first) {
+            Node* a = first;
+            Node* b = a->sibling;
+            first = b ? b->sibling : nullptr;
+            a->sibling = a->prev = nullptr;
+            if (b) b->sibling = b->prev = nullptr;
+            pairs.push_back(link(a, b));
+        }
+        Node* result = pairs.back();
+        for (size_t i = pairs.size() - 1; i-- > 0;) result = link(pairs[i], result);
+        return result;
+    }
+
+    /* Detach a non-root node (with its subtree) from its parent's child list */
+    void cut(Node* node) {
+        if (node->prev->child == node) node->prev->child = node->sibling;
+        else node->prev->sibling = node->sibling;
+        if (node->sibling) node->sibling->prev = node->prev;
+        node->sibling = node->prev = nullptr;
+    }
+
+public:
+    explicit PairingHeap(shared_ptr<Pool> p = make_shared<Pool>()) : pool(move(p)) {}
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+    ~PairingHeap() {
+        // Iterative teardown: walk the tree with an explicit stack
+        vector<Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            Node* n = stack.back();
+            stack.pop_back();
+            for (Node* c = n->child; c; c = c->sibling) stack.push_back(c);
+            pool->destroy(n);
+        }
+    }
+
+    bool empty() const { return root == nullptr; }
+    size_t size() const { return count; }
+    const T& top() const { return root->value; }
+    const shared_ptr<Pool>& allocator() const { return pool; }
+
+    Handle push(T value) {
+        Node* node = pool->create(move(value));
+        root = link(root, node);
+        count++;
+        return node;
+    }
+
+    void pop() {
+        Node* old = root;
+        root = combine(root->child);
+        pool->destroy(old);
+        count--;
+    }
+
+    /* Make the Item behind 'h' more important (new value must not be worse) */
+    void decreaseKey(Handle h, T value) {
+        h->value = move(value);
+        if (h == root) return;
+        cut(h);
+        root = link(root, h);
+    }
+
+    /* O(1): steal every node of 'other'; both heaps must share one pool */
+    void meld(PairingHeap& other) {
+        if (pool != other.pool) throw invalid_argument("PairingHeap::meld needs a shared NodePool");
+        root = link(root, other.root);
+        count += other.count;
+        other.root = nullptr;
+        other.count = 0;
+    }
+};
+
+using ItemHeap = PairingHeap<Item, CompareItem>;
+
+/* DEMO */
+void basicDemo() {
+    auto pool = make_shared<ItemHeap::Pool>();
+    ItemHeap shardA(pool), shardB(pool);
+    shardA.push(Item(3, "Whey Protein"));
+    auto dumbbells = shardA.push(Item(5, "Dumbbells"));
+    shardB.push(Item(1, "Eggs"));
+    shardB.push(Item(2, "Cables"));
+
+    shardA.meld(shardB);                                 // O(1) consolidation
+    shardA.decreaseKey(dumbbells, Item(0, "Dumbbells")); // now the most important
+
+    cout << "Items in order of priority:\n";
+    while (!shardA.empty()) {
+        const Item& i = shardA.top();
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+        shardA.pop();
+    }
+}
+
+/* BENCHMARK 1: consolidate many shard backlogs into one, then drain */
+void meldBenchmark(int shards, int perShard) {
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+    mt19937 rng(9);
+    uniform_int_distribution<int> dist(0, 1 << 30);
+    vector<vector<int>> data(shards, vector<int>(perShard));
+    for (auto& shard : data)
+        for (int& p : shard) p = dist(rng);
+
+    long long c1 = 0, c2 = 0;
+    double stdMerge, stdDrain, phMerge, phDrain;
+    {
+        vector<priority_queue<Item, vector<Item>, CompareItem>> queues(shards);
+        for (int s = 0; s < shards; s++)
+            for (int p : data[s]) queues[s].push(Item(p, "job"));
+        auto t0 = Clock::now();
+        for (int s = 1; s < shards; s++) {
+            while (!queues[s].empty()) {
+                queues[0].push(queues[s].top());
+                queues[s].pop();
+            }
+        }
+        auto t1 = Clock::now();
+        while (!queues[0].empty()) {
+            c1 += queues[0].top().priority;
+            queues[0].pop();
+        }
+        auto t2 = Clock::now();
+        stdMerge = ms(t1 - t0);
+        stdDrain = ms(t2 - t1);
+    }
+    {
+        auto pool = make_shared<ItemHeap::Pool>();
+        vector<unique_ptr<ItemHeap>> heaps;
+        for (int s = 0; s < shards; s++) {
+            heaps.push_back(make_unique<ItemHeap>(pool));
+            for (int p : data[s]) heaps[s]->push(Item(p, "job"));
+        }
+        auto t0 = Clock::now();
+        for (int s = 1; s < shards; s++) heaps[0]->meld(*heaps[s]);
+        auto t1 = Clock::now();
+        while (!heaps[0]->empty()) {
+            c2 += heaps[0]->top().priority;
+            heaps[0]->pop();
+        }
+        auto t2 = Clock::now();
+        phMerge = ms(t1 - t0);
+        phDrain = ms(t2 - t1);
+    }
+    cout << "\nMeld benchmark (" << shards << " shards x " << perShard << " items):\n"
+         << "  priority_queue: merge " << stdMerge << " ms, drain " << stdDrain << " ms\n"
+         << "  pairing heap:   merge " << phMerge << " ms, drain " << phDrain << " ms\n"
+         << "  checksums match: " << (c1 == c2 ? "yes" : "NO") << endl;
+}
+
+/* BENCHMARK 2: repeated shard merges interleaved with work (meld-heavy steady state) */
+void rollingMeldBenchmark(int rounds, int batch) {
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+    long long c1 = 0, c2 = 0;
+
+    mt19937 rng1(4);
+    uniform_int_distribution<int> dist(0, 1 << 30);
+    auto t0 = Clock::now();
+    {
+        priority_queue<Item, vector<Item>, CompareItem> backlog;
+        for (int r = 0; r < rounds; r++) {
+            priority_queue<Item, vector<Item>, CompareItem> shard;
+            for (int i = 0; i < batch; i++) shard.push(Item(dist(rng1), "job"));
+            while (!shard.empty()) {
+                backlog.push(shard.top());
+                shard.pop();
+            }
+            for (int i = 0; i < batch / 2; i++) {
+                c1 += backlog.top().priority;
+                backlog.pop();
+            }
+        }
+    }
+    auto t1 = Clock::now();
+    mt19937 rng2(4);
+    {
+        auto pool = make_shared<ItemHeap::Pool>();
+        ItemHeap backlog(pool);
+        for (int r = 0; r < rounds; r++) {
+            ItemHeap shard(pool);
+            for (int i = 0; i < batch; i++) shard.push(Item(dist(rng2), "job"));
+            backlog.meld(shard);
+            for (int i = 0; i < batch / 2; i++) {
+                c2 += backlog.top().priority;
+                backlog.pop();
+            }
+        }
+    }
+    auto t2 = Clock::now();
+    cout << "\nRolling meld benchmark (" << rounds << " rounds, shard of " << batch
+         << " merged in, " << batch / 2 << " popped per round):\n"
+         << "  priority_queue: " << ms(t1 - t0) << " ms\n"
+         << "  pairing heap:   " << ms(t2 - t1) << " ms\n"
+         << "  checksums match: " << (c1 == c2 ? "yes" : "NO") << endl;
+}
+
+int main() {
+    basicDemo();
+    meldBenchmark(64, 20000);
+    rollingMeldBenchmark(2000, 2000);
+    return 0;
+}
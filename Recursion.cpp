@@ -11,6 +11,8 @@ int fib(int n){
 // fib(5)
 // fib(4) + fib(3)
 // fib(2) + fib(3) + fib(2) + fib(3)
+// The same subproblems get recomputed again and again, so this is O(phi^n).
+// See FastFibonacci.cpp for an O(log n) version.
 
 // int factorial(int n){
 //     if (n<=1){
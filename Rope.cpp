@@ -0,0 +1,365 @@
+/*
+========================================= ROPE ==========================================
+
+A string type for editing large texts, as a faster alternative to the std::string
+operations shown in Strings.cpp:
+
+    s1.insert(4, s2);  s1.erase(4, 5);  s2.replace(1, 3, s1);  s1.append(s2);
+
+std::string keeps all characters in one contiguous array, so an edit in the middle
+has to move everything after it: O(n) per edit. On a multi-megabyte document that
+is megabytes of memmove for every keystroke.
+
+This Rope is a PIECE TABLE stored in a balanced tree:
+
+- The text is a sequence of pieces. A piece does not hold characters itself; it is
+  (buffer, offset, length), a window into an immutable character buffer. The original
+  text is one buffer; inserted text is appended to an "add" buffer.
+- The pieces are the nodes of an implicit treap: a binary tree ordered by position in
+  the text, balanced by random priorities, where each node stores the total length
+  of its subtree. Finding position i, splitting the tree at i, and joining two trees
+  are all O(log n) on average.
+- insert / erase / replace = split the tree at the edit positions and join the parts
+  together again. No characters are moved; a piece may be cut in two.
+- Nodes are immutable and shared (shared_ptr). An edit copies only the O(log n) nodes
+  on the path it touches. So copying a Rope is O(1), and substr() returns a Rope that
+  shares both nodes and character buffers with the original.
+- Iteration walks the pieces in order (an explicit stack, no recursion):
+  for (char c : rope), or forEachChunk(f) to get whole string_views at once.
+- str() flattens everything back into one std::string when one is needed.
+
+Copies of a Rope are independent values, like std::string copies. Like std::string,
+a Rope must not be modified by one thread while another thread uses it or a copy.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+class Rope {
+    struct Node {
+        shared_ptr<const string> buf; // piece: buf[offset, offset + length)
+        size_t offset, length;
+        shared_ptr<const Node> left, right;
+        size_t total;                 // characters in this whole subtree
+        uint32_t priority;            // treap heap key: parent >= children
+
+        Node(shared_ptr<const string> b, size_t off, size_t len, shared_ptr<const Node> l,
+             shared_ptr<const Node> r, uint32_t prio)
+            : buf(move(b)), offset(off), length(len), left(move(l)), right(move(r)), priority(prio) {
+            total = length + (left ? left->total : 0) + (right ? right->total : 0);
+        }
+
+        string_view piece() const { return string_view(buf->data() + offset, length); }
+    };
+    using Ptr = shared_ptr<const Node>;
+
+    static constexpr size_t ADD_BLOCK = 64 * 1024;
+
+    Ptr root;
+    shared_ptr<string> addBuffer; // inserted text goes here; existing bytes are never changed
+
+    static size_t lengthOf(const Ptr& t) { return t ? t->total : 0; }
+
+    static uint32_t randomPriority() {
+        static mt19937 rng(44);
+        return rng();
+    }
+
+    /* A single-node tree over buf[offset, offset + length), with a fresh random priority */
+    static Ptr pieceNode(shared_ptr<const string> buf, size_t offset, size_t length) {
+        return make_shared<const Node>(move(buf), offset, length, nullptr, nullptr, randomPriority());
+    }
+
+    static Ptr withChildren(const Node& n, Ptr l, Ptr r) {
+        return make_shared<const Node>(n.buf, n.offset, n.length, move(l), move(r), n.priority);
+    }
+
+    /* Splits t into the first 'pos' characters and the rest */
+    static pair<Ptr, Ptr> split(const Ptr& t, size_t pos) {
+        if (!t) return {nullptr, nullptr};
+        size_t leftLen = lengthOf(t->left);
+        if (pos <= leftLen) {
+            auto [a, b] = split(t->left, pos);
+            return {a, withChildren(*t, b, t->right)};
+        }
+        if (pos >= leftLen + t->length) {
+            auto [a, b] = split(t->right, pos - leftLen - t->length);
+            return {withChildren(*t, t->left, a), b};
+        }
+        // pos falls inside this node's piece: cut the piece in two. Each half gets its own
+        // random priority; reusing t->priority for both would tie in merge() and, edit after
+        // edit, degrade the treap into a chain.
+        size_t k = pos - leftLen;
+        Ptr a = merge(t->left, pieceNode(t->buf, t->offset, k));
+        Ptr b = merge(pieceNode(t->buf, t->offset + k, t->length - k), t->right);
+        return {a, b};
+    }
+
+    /* Joins two trees: all of a, then all of b */
+    static Ptr merge(const Ptr& a, const Ptr& b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->priority > b->priority) return withChildren(*a, a->left, merge(a->right, b));
+        return withChildren(*b, merge(a, b->left), b->right);
+    }
+
+    /* A single-node tree holding a copy of text in the add buffer */
+    Ptr leaf(string_view text) {
+        if (text.empty()) return nullptr;
+        if (!addBuffer || addBuffer->size() + text.size() > addBuffer->capacity()) {
+            addBuffer = make_shared<string>();
+            addBuffer->reserve(max(ADD_BLOCK, text.size()));
+        }
+        size_t offset = addBuffer->size();
+        addBuffer->append(text);
+        return pieceNode(addBuffer, offset, text.size());
+    }
+
+    explicit Rope(Ptr r) : root(move(r)) {}
+
+    void checkPosition(size_t pos) const {
+        if (pos > size()) throw out_of_range("Rope: position " + to_string(pos) + " > size " + to_string(size()));
+    }
+
+public:
+    Rope() = default;
+    Rope(string_view text) {
+        if (!text.empty())
+            root = pieceNode(make_shared<const string>(text), 0, text.size());
+    }
+
+    size_t size() const { return lengthOf(root); }
+    bool empty() const { return !root; }
+
+    Rope& insert(size_t pos, string_view text) {
+        checkPosition(pos);
+        auto [a, b] = split(root, pos);
+        root = merge(merge(a, leaf(text)), b);
+        return *this;
+    }
+
+    Rope& erase(size_t pos, size_t count) {
+        checkPosition(pos);
+        count = min(count, size() - pos);
+        auto [a, rest] = split(root, pos);
+        auto [gone, b] = split(rest, count);
+        root = merge(a, b);
+        return *this;
+    }
+
+    Rope& replace(size_t pos, size_t count, string_view text) {
+        checkPosition(pos);
+        count = min(count, size() - pos);
+        auto [a, rest] = split(root, pos);
+        auto [gone, b] = split(rest, count);
+        root = merge(merge(a, leaf(text)), b);
+        return *this;
+    }
+
+    Rope& append(string_view text) {
+        root = merge(root, leaf(text));
+        return *this;
+    }
+
+    Rope& append(const Rope& other) {
+        root = merge(root, other.root); // shares other's nodes
+        return *this;
+    }
+
+    /* Shares storage with *this: O(log n), no characters copied */
+    Rope substr(size_t pos, size_t count) const {
+        checkPosition(pos);
+        auto [a, rest] = split(root, pos);
+        auto [mid, b] = split(rest, count);
+        return Rope(mid);
+    }
+
+    char at(size_t i) const {
+        if (i >= size()) throw out_of_range("Rope::at");
+        const Node* n = root.get();
+        while (true) {
+            size_t leftLen = lengthOf(n->left);
+            if (i < leftLen) n = n->left.get();
+            else if (i < leftLen + n->length) return n->buf->data()[n->offset + i - leftLen];
+            else {
+                i -= leftLen + n->length;
+                n = n->right.get();
+            }
+        }
+    }
+
+    /* Calls f(string_view) for each piece, in order */
+    template <class F>
+    void forEachChunk(F&& f) const {
+        vector<const Node*> stack;
+        const Node* n = root.get();
+        while (n || !stack.empty()) {
+            for (; n; n = n->left.get()) stack.push_back(n);
+            n = stack.back();
+            stack.pop_back();
+            f(n->piece());
+            n = n->right.get();
+        }
+    }
+
+    string str() const {
+        string out;
+        out.reserve(size());
+        forEachChunk([&](string_view chunk) { out.append(chunk); });
+        return out;
+    }
+
+    /* Character iterator: walks the pieces with an explicit stack */
+    class const_iterator {
+        vector<const Node*> stack;
+        const char* cur = nullptr; // nullptr at the end
+        const char* pieceEnd = nullptr;
+
+        void pushLeft(const Node* n) {
+            for (; n; n = n->left.get()) stack.push_back(n);
+        }
+        void nextPiece() {
+            if (stack.empty()) {
+                cur = nullptr;
+                return;
+            }
+            const Node* n = stack.back();
+            stack.pop_back();
+            cur = n->buf->data() + n->offset;
+            pieceEnd = cur + n->length;
+            pushLeft(n->right.get());
+        }
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = char;
+        using difference_type = ptrdiff_t;
+        using pointer = const char*;
+        using reference = const char&;
+
+        const_iterator() = default;
+        explicit const_iterator(const Node* root) {
+            pushLeft(root);
+            nextPiece();
+        }
+
+        const char& operator*() const { return *cur; }
+        const_iterator& operator++() {
+            if (++cur == pieceEnd) nextPiece();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator& o) const { return cur == o.cur; }
+        bool operator!=(const const_iterator& o) const { return cur != o.cur; }
+    };
+
+    const_iterator begin() const { return const_iterator(root.get()); }
+    const_iterator end() const { return const_iterator(); }
+};
+
+/* DEMO (the Strings.cpp examples) */
+void stringsDemo() {
+    Rope s1("12345");
+    string s2 = "abcde";
+    s1.insert(4, s2);
+    cout << s1.str() << endl; // 1234abcde5
+    s1.erase(4, 5);
+    cout << s1.str() << endl; // 12345
+
+    Rope r2(s2);
+    r2.replace(1, 3, s1.str());
+    cout << r2.str() << endl; // a12345e
+
+    Rope s3("12345");
+    s3.append(s2);
+    cout << s3.str() << endl; // 12345abcde
+
+    Rope hello("Hello, World!");
+    Rope sub = hello.substr(0, 5); // shares storage with hello
+    hello.replace(7, 5, "C++");
+    cout << sub.str() << " / " << hello.str() << " / at(7) = " << hello.at(7) << endl;
+
+    for (char c : sub) cout << c << '.';
+    cout << endl;
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+/* Applies the same random edits to a std::string and a Rope; insertPercent of them are inserts */
+void benchmarkEdits(const string& document, int insertPercent) {
+    const int edits = 20000;
+    struct Edit {
+        bool insert;
+        size_t pos;
+    };
+    mt19937 rng(7);
+    vector<Edit> plan;
+    size_t len = document.size();
+    for (int i = 0; i < edits; i++) {
+        bool ins = static_cast<int>(rng() % 100) < insertPercent;
+        size_t pos = rng() % (len - 8);
+        plan.push_back({ins, pos});
+        len += ins ? 5 : -5;
+    }
+
+    string flat = document;
+    Rope rope(document);
+    double tString = timeMs([&] {
+        for (const Edit& e : plan) e.insert ? (void)flat.insert(e.pos, "EDIT!") : (void)flat.erase(e.pos, 5);
+    });
+    double tRope = timeMs([&] {
+        for (const Edit& e : plan) e.insert ? (void)rope.insert(e.pos, "EDIT!") : (void)rope.erase(e.pos, 5);
+    });
+    string flattened;
+    double tFlatten = timeMs([&] { flattened = rope.str(); });
+    size_t sum = 0;
+    double tIterate = timeMs([&] {
+        for (char c : rope) sum += static_cast<unsigned char>(c);
+    });
+    Rope sub;
+    double tSubstr = timeMs([&] { sub = rope.substr(rope.size() / 3, rope.size() / 3); });
+
+    cout << "\nBenchmark: " << edits << " random edits (" << insertPercent << "% inserts) on an "
+         << document.size() / (1 << 20) << " MB document\n"
+         << "  std::string: " << tString << " ms\n"
+         << "  Rope:        " << tRope << " ms (results " << (flattened == flat ? "match" : "DIFFER") << ")\n"
+         << "  Rope flatten " << tFlatten << " ms, char iteration " << tIterate << " ms, substr of a third "
+         << tSubstr << " ms\n";
+}
+
+void benchmark() {
+    string document;
+    for (int i = 0; document.size() < (8u << 20); i++) document += "line " + to_string(i) + " of the document\n";
+
+    benchmarkEdits(document, 50);
+    // Every erase cuts pieces, so this is the workload that shows whether the tree stays balanced
+    benchmarkEdits(document, 0);
+}
+
+int main() {
+    stringsDemo();
+    benchmark();
+    return 0;
+}
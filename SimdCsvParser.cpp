@@ -0,0 +1,425 @@
+/*
+=================================== SIMD CSV PARSER ====================================
+
+A CSV engine in the style of simdjson, replacing parseCSV() from StringStreams.cpp:
+
+    while (getline(ss, token, ',')) ...   // copies every token, and breaks on "a,b"
+
+Two stages:
+
+Stage 1 - structural index (the hot loop)
+  Process the input 64 bytes at a time. With SSE2 (four 16-byte compares) build three
+  64-bit masks: where the '"', ',' and '\n' bytes are.
+  Which bytes are inside quotes? Take the prefix XOR of the quote mask: every quote
+  flips the state, so bit i of
+        inside = q ^ (q << 1) ^ (q << 2) ^ ... (computed in 6 shift/xor steps)
+  is 1 exactly when byte i is inside a quoted field. An escaped quote ("") flips
+  twice, so it needs no special case. The last bit carries into the next block.
+        separators = (commas | newlines) & ~inside
+  The set bits are then extracted with count-trailing-zeros into a flat vector of
+  positions: the "field offsets index". No per-character branches.
+
+Stage 2 - typed column extraction
+  Field k spans from separator k-1 (+1) to separator k; a '\n' separator ends a row.
+  column<int64_t>(c) / column<double>(c) use from_chars (no locale, no allocation);
+  strings(c) removes the surrounding quotes and turns "" into ".
+
+RFC 4180 details handled: quoted fields containing ',', '\n' and "", CRLF line ends,
+missing final newline.
+
+Parallel chunks
+  Split the buffer into one chunk per thread. A chunk cannot know whether it starts
+  inside quotes, so first every thread classifies its chunk and counts its quotes and
+  its separators (for both possible starting states). Prefix sums of those counts give
+  each chunk its starting quote state and its exact place in the shared index, so
+  stage 1 then writes every chunk straight into the final array, with no concatenation.
+
+Compile with -pthread (and -O2; -march=native lets the compiler use wider vectors).
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <charconv>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+/* STAGE 1 */
+
+struct BlockMasks {
+    uint64_t quote, comma, newline;
+};
+
+static inline BlockMasks classify(const char* p) {
+#ifdef __SSE2__
+    const __m128i q = _mm_set1_epi8('"'), c = _mm_set1_epi8(','), n = _mm_set1_epi8('\n');
+    BlockMasks m{0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        m.quote |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, q)))) << (16 * i);
+        m.comma |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c)))) << (16 * i);
+        m.newline |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, n)))) << (16 * i);
+    }
+    return m;
+#else
+    BlockMasks m{0, 0, 0};
+    for (int i = 0; i < 64; i++) {
+        m.quote |= static_cast<uint64_t>(p[i] == '"') << i;
+        m.comma |= static_cast<uint64_t>(p[i] == ',') << i;
+        m.newline |= static_cast<uint64_t>(p[i] == '\n') << i;
+    }
+    return m;
+#endif
+}
+
+static inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/* Separator entries: (position << 1) | 1 if the separator is a newline.
+   32-bit entries halve the index's memory traffic; inputs are limited to 2 GB. */
+constexpr size_t MAX_CSV_BYTES = (size_t(1) << 31) - 1;
+
+/* Growable array of separator entries. Unlike vector::resize it never zero-fills:
+   stage 1 asks for room, writes the entries and then commits them. Growing uses
+   realloc, which for large blocks remaps pages instead of copying them. */
+class SeparatorIndex {
+    struct Free {
+        void operator()(uint32_t* p) const { free(p); }
+    };
+    unique_ptr<uint32_t, Free> buf;
+    size_t count = 0, cap = 0;
+
+public:
+    size_t newlines = 0; // entries with the newline bit, counted by stage 1
+
+    void reserve(size_t n) {
+        if (n <= cap) return;
+        void* p = realloc(buf.get(), n * sizeof(uint32_t));
+        if (!p) throw bad_alloc();
+        buf.release();
+        buf.reset(static_cast<uint32_t*>(p));
+        cap = n;
+    }
+    uint32_t* room(size_t n) {
+        if (count + n > cap) reserve(max(cap * 2, count + n));
+        return buf.get() + count;
+    }
+    void commit(size_t n, size_t newlineEntries) {
+        count += n;
+        newlines += newlineEntries;
+    }
+    void push_back(uint32_t e) {
+        *room(1) = e;
+        commit(1, e & 1);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint32_t operator[](size_t i) const { return buf.get()[i]; }
+    uint32_t back() const { return buf.get()[count - 1]; }
+    uint32_t* data() { return buf.get(); }
+};
+
+/* Output of one parallel chunk: a slice of the final index sized exactly in advance */
+struct IndexSlice {
+    uint32_t* next;
+    size_t newlines = 0;
+
+    uint32_t* room(size_t) { return next; }
+    void commit(size_t n, size_t newlineEntries) {
+        next += n;
+        newlines += newlineEntries;
+    }
+};
+
+template <class Out>
+static void indexChunk(const char* data, size_t begin, size_t end, bool startsInside, Out& out) {
+    uint64_t carry = startsInside ? ~0ull : 0;
+    char tail[64];
+    for (size_t pos = begin; pos < end; pos += 64) {
+        const char* block = data + pos;
+        size_t len = min<size_t>(64, end - pos);
+        if (len < 64) { // pad the last partial block with harmless bytes
+            memset(tail, ' ', sizeof tail);
+            memcpy(tail, block, len);
+            block = tail;
+        }
+        BlockMasks m = classify(block);
+        uint64_t inside = prefixXor(m.quote) ^ carry;
+        carry = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63); // all ones if still inside
+
+        uint64_t seps = (m.comma | m.newline) & ~inside;
+        if (!seps) continue;
+        size_t n = static_cast<size_t>(__builtin_popcountll(seps));
+        uint32_t* dst = out.room(n); // one size update per block, not per field
+        do {
+            int bit = __builtin_ctzll(seps);
+            *dst++ = static_cast<uint32_t>(((pos + bit) << 1) | ((m.newline >> bit) & 1));
+            seps &= seps - 1;
+        } while (seps);
+        out.commit(n, static_cast<size_t>(__builtin_popcountll(m.newline & ~inside)));
+    }
+}
+
+/* Parallel pass 1: a chunk's quote count, and how many separators it has if it starts
+   outside quotes. Starting inside complements the inside mask, so the other case is
+   candidates - separators. */
+struct ChunkCounts {
+    size_t quotes = 0, candidates = 0, separators = 0;
+};
+
+static ChunkCounts countChunk(const char* data, size_t begin, size_t end) {
+    ChunkCounts c;
+    uint64_t carry = 0;
+    char tail[64];
+    for (size_t pos = begin; pos < end; pos += 64) {
+        const char* block = data + pos;
+        size_t len = min<size_t>(64, end - pos);
+        if (len < 64) {
+            memset(tail, ' ', sizeof tail);
+            memcpy(tail, block, len);
+            block = tail;
+        }
+        BlockMasks m = classify(block);
+        uint64_t inside = prefixXor(m.quote) ^ carry;
+        carry = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+        c.quotes += static_cast<size_t>(__builtin_popcountll(m.quote));
+        c.candidates += static_cast<size_t>(__builtin_popcountll(m.comma | m.newline));
+        c.separators += static_cast<size_t>(__builtin_popcountll((m.comma | m.newline) & ~inside));
+    }
+    return c;
+}
+
+/* STAGE 2 */
+
+class CsvTable {
+    string_view data;
+    SeparatorIndex seps;       // every field ends at one of these
+    vector<uint32_t> rowStart; // index into seps of each row's first field
+
+    static bool isNewline(uint32_t e) { return e & 1; }
+    static size_t position(uint32_t e) { return static_cast<size_t>(e >> 1); }
+
+public:
+    CsvTable(string_view text, SeparatorIndex separators) : data(text), seps(move(separators)) {
+        // A final row without a trailing newline still needs an end marker
+        if (!data.empty() && (seps.empty() || position(seps.back()) != data.size() - 1 || !isNewline(seps.back())))
+            seps.push_back(static_cast<uint32_t>(data.size() << 1) | 1);
+        if (seps.empty()) return;
+        // Branchless: always write the candidate start, advance only after a newline
+        rowStart.resize(seps.newlines + 1);
+        uint32_t* out = rowStart.data();
+        size_t rows = 1;
+        for (size_t i = 0; i + 1 < seps.size(); i++) {
+            out[rows] = static_cast<uint32_t>(i + 1);
+            rows += seps[i] & 1;
+        }
+        rowStart.resize(rows);
+    }
+
+    size_t rows() const { return rowStart.size(); }
+    size_t columns(size_t row) const {
+        size_t last = row + 1 < rowStart.size() ? rowStart[row + 1] : seps.size();
+        return last - rowStart[row];
+    }
+    size_t separators() const { return seps.size(); }
+
+    /* Raw field text (still quoted, if it was quoted); CR of a CRLF is dropped */
+    string_view raw(size_t row, size_t col) const {
+        size_t k = rowStart[row] + col;
+        size_t begin = k == 0 ? 0 : position(seps[k - 1]) + 1;
+        size_t end = position(seps[k]);
+        if (isNewline(seps[k]) && end > begin && data[end - 1] == '\r') end--;
+        return data.substr(begin, end - begin);
+    }
+
+    /* Field text with RFC 4180 quoting removed */
+    string text(size_t row, size_t col) const {
+        string_view f = raw(row, col);
+        if (f.size() < 2 || f.front() != '"') return string(f);
+        string out;
+        out.reserve(f.size() - 2);
+        for (size_t i = 1; i + 1 < f.size(); i++) {
+            out += f[i];
+            if (f[i] == '"') i++; // "" -> "
+        }
+        return out;
+    }
+
+    template <class T>
+    vector<T> column(size_t col) const {
+        vector<T> out;
+        out.reserve(rows());
+        for (size_t r = 0; r < rows(); r++) {
+            if (col >= columns(r)) throw out_of_range("row " + to_string(r) + " has no column " + to_string(col));
+            string_view f = raw(r, col);
+            T value{};
+            auto res = from_chars(f.data(), f.data() + f.size(), value);
+            if (res.ec != errc() || res.ptr != f.data() + f.size())
+                throw invalid_argument("row " + to_string(r) + ": '" + string(f) + "' is not a number");
+            out.push_back(value);
+        }
+        return out;
+    }
+
+    vector<string> strings(size_t col) const {
+        vector<string> out;
+        out.reserve(rows());
+        for (size_t r = 0; r < rows(); r++) out.push_back(text(r, col));
+        return out;
+    }
+};
+
+/* Single-threaded and chunked-parallel front ends */
+CsvTable parseCsv(string_view text) {
+    if (text.size() > MAX_CSV_BYTES) throw length_error("CSV input larger than 2 GB; parse it in pieces");
+    SeparatorIndex seps;
+    seps.reserve(text.size() / 8 + 1);
+    indexChunk(text.data(), 0, text.size(), false, seps);
+    return CsvTable(text, move(seps));
+}
+
+CsvTable parseCsvParallel(string_view text, int threads) {
+    if (text.size() > MAX_CSV_BYTES) throw length_error("CSV input larger than 2 GB; parse it in pieces");
+    size_t n = text.size();
+    vector<size_t> bounds(threads + 1);
+    for (int t = 0; t <= threads; t++) bounds[t] = n * t / threads;
+    bounds[threads] = n;
+
+    // Pass 1: quote count and separator count of each chunk
+    vector<ChunkCounts> counts(threads);
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back([&, t] { counts[t] = countChunk(text.data(), bounds[t], bounds[t + 1]); });
+    for (auto& th : pool) th.join();
+    pool.clear();
+
+    // Pass 2: every chunk knows whether it starts inside quotes and where its entries go,
+    // so it writes straight into the final index
+    SeparatorIndex seps;
+    vector<bool> inside(threads);
+    vector<size_t> offset(threads + 1, 0);
+    size_t parity = 0;
+    for (int t = 0; t < threads; t++) {
+        inside[t] = parity & 1;
+        parity += counts[t].quotes;
+        offset[t + 1] = offset[t] + (inside[t] ? counts[t].candidates - counts[t].separators : counts[t].separators);
+    }
+    uint32_t* base = seps.room(offset[threads] + 1); // +1: CsvTable may append an end marker
+    vector<size_t> newlines(threads);
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            IndexSlice slice{base + offset[t]};
+            indexChunk(text.data(), bounds[t], bounds[t + 1], inside[t], slice);
+            newlines[t] = slice.newlines;
+        });
+    }
+    for (auto& th : pool) th.join();
+    size_t totalNewlines = 0;
+    for (size_t nl : newlines) totalNewlines += nl;
+    seps.commit(offset[threads], totalNewlines);
+    return CsvTable(text, move(seps));
+}
+
+/* DEMO */
+void demo() {
+    string csv = "id,name,score\r\n"
+                 "1,\"Smith, John\",91.5\r\n"
+                 "2,\"He said \"\"hi\"\"\",78\r\n"
+                 "3,\"multi\nline\",88.25"; // no final newline
+    CsvTable table = parseCsv(csv);
+    cout << table.rows() << " rows\n";
+    for (size_t r = 0; r < table.rows(); r++) {
+        for (size_t c = 0; c < table.columns(r); c++) cout << "[" << table.text(r, c) << "]";
+        cout << "\n";
+    }
+    CsvTable body = parseCsv(string_view(csv).substr(csv.find('\n') + 1));
+    double total = 0;
+    for (double s : body.column<double>(2)) total += s;
+    cout << "sum of scores = " << total << "\n";
+}
+
+/* BENCHMARK */
+template <class F>
+double timeSeconds(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double>(t1 - t0).count();
+}
+
+void benchmark(size_t megabytes) {
+    mt19937 rng(8);
+    string csv;
+    csv.reserve((megabytes << 20) + 256);
+    for (long long row = 0; csv.size() < (megabytes << 20); row++) {
+        csv += to_string(row);
+        csv += ',';
+        csv += to_string(rng() % 100000);
+        csv += ",\"note ";
+        csv += (row % 7 == 0) ? "with, comma" : (row % 11 == 0 ? "with \"\"quotes\"\"" : "plain");
+        csv += "\",";
+        csv += to_string(rng() % 1000);
+        csv += ".25\n";
+    }
+    double gb = csv.size() / 1e9;
+
+    size_t naiveTokens = 0;
+    double tNaive = timeSeconds([&] {
+        stringstream ss(csv);
+        string token;
+        while (getline(ss, token, ',')) naiveTokens++;
+    });
+
+    size_t seps = 0;
+    double tStage1 = 1e9;
+    for (int rep = 0; rep < 3; rep++) // best of 3: the first run also pays for page faults
+        tStage1 = min(tStage1, timeSeconds([&] { seps = parseCsv(csv).separators(); }));
+
+    long long sum = 0;
+    double tColumn = 0;
+    CsvTable table = parseCsv(csv);
+    tColumn = timeSeconds([&] {
+        for (long long v : table.column<long long>(1)) sum += v;
+    });
+
+    cout << "\nBenchmark on " << csv.size() / (1 << 20) << " MB (" << table.rows() << " rows):\n"
+         << "  stringstream getline (no quote handling): " << gb / tNaive << " GB/s\n"
+         << "  structural index, 1 thread:              " << gb / tStage1 << " GB/s (" << seps << " separators)\n"
+         << "  int column extraction:                   " << table.rows() / tColumn / 1e6 << " M values/s\n";
+
+    for (int threads : {2, 4}) {
+        size_t sepsParallel = 0;
+        double t = timeSeconds([&] { sepsParallel = parseCsvParallel(csv, threads).separators(); });
+        cout << "  structural index, " << threads << " threads:             " << gb / t << " GB/s"
+             << (sepsParallel == seps ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+int main() {
+    demo();
+    benchmark(256);
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+================================ SoA PRIORITY QUEUE ====================================
+
+Key/payload split ("Structure of Arrays") min-heap for the Item model used in
+CustomComparatorForPriorityQueue.cpp.
+
+Why?
+  priority_queue<Item, vector<Item>, CompareItem> sifts whole Item objects around.
+  Every swap moves an int AND a std::string (32 bytes on most 64-bit libraries),
+  even though CompareItem only ever reads 'priority'.
+
+Idea:
+  - keys    -> dense vector of small (priority, slot) pairs. The heap lives here.
+  - payload -> separate "slab" of descriptions indexed by slot. It never moves
+               while the item is queued; freed slots are recycled.
+  Sift-up / sift-down compare and swap 8-byte keys only, so far more of the heap
+  fits in cache. The description is fetched exactly once, when the item is popped.
+
+The interface mirrors priority_queue: push / top / pop / empty / size.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+/* Same ordering as CustomComparatorForPriorityQueue.cpp (lower value = higher priority) */
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* SoA HEAP */
+class SoAPriorityQueue {
+    struct Key {
+        int priority;   // the only field the heap ever compares
+        uint32_t slot;  // where the payload lives in 'descriptions'
+    };
+
+    vector<Key> keys;            // binary heap of keys (root = smallest priority)
+    vector<string> descriptions; // payload slab, indexed by Key::slot
+    vector<uint32_t> freeSlots;  // recycled slab entries
+
+    /* Hole-based sifting: keep the moving key in a register and shift others into the hole */
+    void siftUp(size_t i) {
+        Key k = keys[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (keys[parent].priority <= k.priority) break;
+            keys[i] = keys[parent];
+            i = parent;
+        }
+        keys[i] = k;
+    }
+
+    void siftDown(size_t i) {
+        size_t n = keys.size();
+        Key k = keys[i];
+        while (true) {
+            size_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && keys[child + 1].priority < keys[child].priority) child++;
+            if (k.priority <= keys[child].priority) break;
+            keys[i] = keys[child];
+            i = child;
+        }
+        keys[i] = k;
+    }
+
+public:
+    void reserve(size_t n) {
+        keys.reserve(n);
+        descriptions.reserve(n);
+    }
+
+    bool empty() const { return keys.empty(); }
+    size_t size() const { return keys.size(); }
+
+    void push(int priority, string description) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            descriptions[slot] = move(description);
+        } else {
+            slot = static_cast<uint32_t>(descriptions.size());
+            descriptions.push_back(move(description));
+        }
+        keys.push_back({priority, slot});
+        siftUp(keys.size() - 1);
+    }
+
+    void push(Item item) { push(item.priority, move(item.description)); }
+
+    /* Peeking touches only the key array, plus one payload lookup if asked for */
+    int topPriority() const { return keys.front().priority; }
+    const string& topDescription() const { return descriptions[keys.front().slot]; }
+
+    /* Removes the root and hands back the full Item (payload moved out once) */
+    Item pop() {
+        Key root = keys.front();
+        Item result(root.priority, move(descriptions[root.slot]));
+        freeSlots.push_back(root.slot);
+
+        keys.front() = keys.back();
+        keys.pop_back();
+        if (!keys.empty()) siftDown(0);
+        return result;
+    }
+};
+
+/* DEMO (same items as CustomComparatorForPriorityQueue.cpp) */
+void basicDemo() {
+    SoAPriorityQueue itemQueue;
+    itemQueue.push(Item(3, "Whey Protein"));
+    itemQueue.push(Item(1, "Eggs"));
+    itemQueue.push(Item(5, "Dumbbells"));
+    itemQueue.push(Item(2, "Cables"));
+
+    cout << "Items in order of priority:\n";
+    while (!itemQueue.empty()) {
+        Item i = itemQueue.pop();
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+    }
+}
+
+/* BENCHMARK: "hold" model, the steady state of a scheduler
+   Keep N items queued; repeatedly take the most important one and re-queue it
+   with a later priority. The std::priority_queue loop is written exactly like
+   CustomComparatorForPriorityQueue.cpp (copy top(), then pop()). */
+void benchmark(size_t n, size_t ops) {
+    const string payload = "description that lives on the heap #"; // beats small-string optimization
+    uniform_int_distribution<int> dist(0, 1 << 20);
+
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+    long long checksum1 = 0, checksum2 = 0;
+
+    mt19937 rng1(42);
+    priority_queue<Item, vector<Item>, CompareItem> pq;
+    for (size_t i = 0; i < n; i++) pq.push(Item(dist(rng1), payload));
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < ops; i++) {
+        Item it = pq.top();
+        pq.pop();
+        checksum1 += it.priority;
+        it.priority += dist(rng1);
+        pq.push(move(it));
+    }
+    auto t1 = Clock::now();
+
+    mt19937 rng2(42);
+    SoAPriorityQueue soa;
+    soa.reserve(n);
+    for (size_t i = 0; i < n; i++) soa.push(dist(rng2), payload);
+    auto t2 = Clock::now();
+    for (size_t i = 0; i < ops; i++) {
+        Item it = soa.pop();
+        checksum2 += it.priority;
+        it.priority += dist(rng2);
+        soa.push(move(it));
+    }
+    auto t3 = Clock::now();
+
+    cout << "\nBenchmark (" << n << " queued items, " << ops << " pop+push rounds):\n"
+         << "  priority_queue<Item>: " << ms(t1 - t0) << " ms\n"
+         << "  SoAPriorityQueue:     " << ms(t3 - t2) << " ms\n"
+         << "  checksums match: " << (checksum1 == checksum2 ? "yes" : "NO") << endl;
+}
+
+int main() {
+    basicDemo();
+    benchmark(1000000, 2000000);
+    return 0;
+}
@@ -0,0 +1,301 @@
+/*
+===================================== STREAM POOL =======================================
+
+clearStringstream() in StringStreams.cpp shows how a stringstream is reused:
+
+    ss.str("");   // clears buffer
+    ss.clear();   // clears flags
+
+Most code does not bother and builds a fresh stream every time it formats or parses
+a few values. That is the expensive part: constructing a stream sets up ios_base,
+imbues the global locale (reference counting, facet lookups) and allocates a buffer.
+Doing it once per call can cost far more than the formatting itself.
+
+This file keeps finished streams and strings around for reuse:
+
+- StreamPool<T>: a per-thread (thread_local) free list of T objects. Because every
+  thread has its own list there is no locking at all.
+- Lease<T>: RAII handle. The constructor takes an object from the calling thread's
+  pool (or creates one if the pool is empty); the destructor resets it and puts
+  it back. Use it like a pointer: *lease, lease->.
+      FormatLease  = Lease<ostringstream>   (cleared with str(""), clear(), and the
+                                             default flags/precision/fill/width)
+      ParseLease   = Lease<istringstream>   (loaded with the text to parse)
+      StringLease  = Lease<string>          (clear() keeps the capacity)
+- Nested leases on one thread simply get different objects.
+- Everything a user can change is reset: flags, precision, width, fill, exception
+  mask and locale.
+- A pool keeps at most MAX_POOLED objects, and a string or stream whose buffer has
+  grown beyond MAX_RETAINED_CAPACITY is freed instead of kept, so one huge message
+  does not pin memory forever. For streams the capacity is read from the buffer's put
+  area, so this holds even when the user already cleared the text.
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <sstream>
+#include <locale>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+constexpr size_t MAX_POOLED = 8;
+constexpr size_t MAX_RETAINED_CAPACITY = 64 * 1024;
+
+/* RESETTING OBJECTS FOR REUSE (returns false if the object should be dropped instead) */
+
+/* State every stream gets back, whatever the previous user changed */
+void resetStreamState(ios& s) {
+    s.clear();
+    s.exceptions(ios_base::goodbit);
+    s.flags(ios_base::dec | ios_base::skipws);
+    s.precision(6);
+    s.width(0);
+    s.fill(' ');
+    if (s.getloc() != locale()) s.imbue(locale()); // what a new stream gets; imbuing is not free
+}
+
+/* Characters a stringbuf holds without reallocating. When the buffer is open for output, its
+   put area spans the whole string, capacity included, and it still does after str(""). The
+   member pointers are taken through this derived class, which is what makes the protected
+   pbase()/epptr() of any stringbuf reachable. */
+struct BufferCapacity : stringbuf {
+    static size_t of(const stringbuf& b) {
+        char* (streambuf::*begin)() const = &BufferCapacity::pbase;
+        char* (streambuf::*end)() const = &BufferCapacity::epptr;
+        return static_cast<size_t>((b.*end)() - (b.*begin)());
+    }
+};
+
+/* str("") keeps the buffer's capacity, so a stream whose buffer has grown too large is dropped
+   instead, even if its last user already cleared the text */
+bool resetForReuse(ostringstream& s) {
+    if (BufferCapacity::of(*s.rdbuf()) > MAX_RETAINED_CAPACITY) return false;
+    s.str("");
+    resetStreamState(s);
+    return true;
+}
+
+bool resetForReuse(istringstream& s) {
+    if (BufferCapacity::of(*s.rdbuf()) > MAX_RETAINED_CAPACITY) return false;
+    s.str("");
+    resetStreamState(s);
+    return true;
+}
+
+bool resetForReuse(string& s) {
+    s.clear();
+    return s.capacity() <= MAX_RETAINED_CAPACITY;
+}
+
+/* New pooled objects. An istringstream is opened for output too, only so that its buffer
+   has a put area for BufferCapacity to measure; the stream itself still just reads. */
+template <class T>
+unique_ptr<T> createPooled() {
+    return make_unique<T>();
+}
+
+template <>
+unique_ptr<istringstream> createPooled() {
+    return make_unique<istringstream>(ios_base::in | ios_base::out);
+}
+
+/* PER-THREAD POOL */
+template <class T>
+class StreamPool {
+    vector<unique_ptr<T>> freeList;
+    size_t created = 0;
+
+    StreamPool() { freeList.reserve(MAX_POOLED); }
+
+public:
+    static StreamPool& local() {
+        thread_local StreamPool pool;
+        return pool;
+    }
+
+    unique_ptr<T> acquire() {
+        if (freeList.empty()) {
+            created++;
+            return createPooled<T>();
+        }
+        unique_ptr<T> obj = move(freeList.back());
+        freeList.pop_back();
+        return obj;
+    }
+
+    void release(unique_ptr<T> obj) {
+        if (resetForReuse(*obj) && freeList.size() < MAX_POOLED) freeList.push_back(move(obj));
+    }
+
+    size_t objectsCreated() const { return created; }
+    size_t pooled() const { return freeList.size(); }
+};
+
+/* RAII LEASE */
+template <class T>
+class Lease {
+    unique_ptr<T> obj;
+
+public:
+    Lease() : obj(StreamPool<T>::local().acquire()) {}
+    ~Lease() {
+        if (obj) StreamPool<T>::local().release(move(obj));
+    }
+
+    Lease(Lease&&) = default;
+    Lease& operator=(Lease&&) = delete;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    T& operator*() const { return *obj; }
+    T* operator->() const { return obj.get(); }
+};
+
+using FormatLease = Lease<ostringstream>;
+using StringLease = Lease<string>;
+
+class ParseLease : public Lease<istringstream> {
+public:
+    explicit ParseLease(string_view text) {
+        StringLease scratch; // the stream copies the text anyway; reuse a pooled string to hold it
+        scratch->assign(text);
+        (*this)->str(*scratch);
+    }
+};
+
+/* DEMOS */
+void clearStringstreamDemo() {
+    {
+        FormatLease ss;
+        *ss << "Test " << hex << 255; // leaves the stream in hex mode...
+        cout << ss->str() << "\n";
+    }
+    {
+        FormatLease ss; // ...but the next user gets the same stream back, reset
+        *ss << 255;
+        cout << ss->str() << " (objects created: " << StreamPool<ostringstream>::local().objectsCreated() << ")\n";
+    }
+}
+
+void resetDemo() {
+    StreamPool<ostringstream>& pool = StreamPool<ostringstream>::local();
+    {
+        FormatLease ss;
+        ss->exceptions(ios_base::failbit);
+        ss->imbue(locale(locale::classic(), new numpunct<char>)); // a distinct locale object
+        *ss << "small";
+    }
+    {
+        size_t before = pool.objectsCreated();
+        FormatLease same;
+        cout << "reused: " << (pool.objectsCreated() == before) << ", exceptions mask " << same->exceptions()
+             << ", default locale " << (same->getloc() == locale()) << "\n";
+        *same << string(2 * MAX_RETAINED_CAPACITY, 'x');
+        same->str(""); // the text is gone, but the 128 KB buffer is not
+    }
+    size_t before = pool.objectsCreated();
+    {
+        FormatLease next;
+        cout << "after a 128 KB message the stream was " << (pool.objectsCreated() > before ? "dropped" : "KEPT")
+             << "\n";
+    }
+    StreamPool<istringstream>& parsePool = StreamPool<istringstream>::local();
+    { ParseLease big(string(2 * MAX_RETAINED_CAPACITY, '1')); }
+    before = parsePool.objectsCreated();
+    ParseLease small("1");
+    cout << "after parsing 128 KB the stream was " << (parsePool.objectsCreated() > before ? "dropped" : "KEPT") << "\n";
+}
+
+void parseDemo() {
+    ParseLease in("10 20 30");
+    int a, b, c;
+    *in >> a >> b >> c;
+    cout << a + b + c << "\n";
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    const int n = 1000000;
+    size_t len1 = 0, len2 = 0;
+    double tFresh = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            ostringstream ss;
+            ss << "id=" << i << " x=" << i * 0.5;
+            len1 += ss.str().size();
+        }
+    });
+    double tLease = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            FormatLease ss;
+            *ss << "id=" << i << " x=" << i * 0.5;
+            len2 += ss->str().size();
+        }
+    });
+    cout << "\nBenchmark (" << n << " calls):\n  format: new ostringstream " << tFresh << " ms, FormatLease " << tLease
+         << " ms" << (len1 == len2 ? "" : " (MISMATCH)") << "\n";
+
+    string text = "123 456";
+    long long sum1 = 0, sum2 = 0;
+    tFresh = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            istringstream in(text);
+            int a, b;
+            in >> a >> b;
+            sum1 += a + b;
+        }
+    });
+    tLease = timeMs([&] {
+        for (int i = 0; i < n; i++) {
+            ParseLease in(text);
+            int a, b;
+            *in >> a >> b;
+            sum2 += a + b;
+        }
+    });
+    cout << "  parse:  new istringstream " << tFresh << " ms, ParseLease " << tLease << " ms"
+         << (sum1 == sum2 ? "" : " (MISMATCH)") << "\n";
+
+    // Every thread has its own pool: no locks, and each creates only a stream or two
+    const int threads = 4;
+    vector<size_t> created(threads);
+    vector<thread> pool;
+    double tThreads = timeMs([&] {
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&, t] {
+                for (int i = 0; i < n / threads; i++) {
+                    FormatLease ss;
+                    *ss << t << ':' << i;
+                }
+                created[t] = StreamPool<ostringstream>::local().objectsCreated();
+            });
+        }
+        for (auto& th : pool) th.join();
+    });
+    cout << "  " << threads << " threads x " << n / threads << " leases: " << tThreads << " ms, streams created per thread:";
+    for (size_t c : created) cout << " " << c;
+    cout << "\n";
+}
+
+int main() {
+    clearStringstreamDemo();
+    resetDemo();
+    parseDemo();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,200 @@
+/*
+=================================== STREAMING TOP-K ====================================
+
+Keeping only the K most important Items out of an unbounded stream.
+
+The naive way is what CustomComparatorForPriorityQueue.cpp does: push every Item into
+priority_queue<Item, vector<Item>, CompareItem> and pop the first K. Memory grows with
+the stream and every Item pays O(log n).
+
+TopK instead keeps a fixed-capacity heap ordered the OTHER way round: its root is
+the WORST Item still being kept (largest priority value). Then for each new Item:
+  - if we hold fewer than K, keep it;
+  - else if it is not better than the root, reject it        <- one int compare
+  - else replace the root and sift down (O(log K)).
+The root's priority is cached in 'threshold', so once the heap has warmed up almost
+every Item is rejected without touching the heap or copying its string.
+
+Parallel streams:
+  Every thread fills its own TopK over its share of the stream, then the partials are
+  merged (offer every kept Item of one into the other). Memory stays O(K * threads),
+  and there is no sharing at all while streaming.
+
+"Most important" follows CompareItem: lower priority value = higher priority.
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* Keeps the worst kept Item on top (reverse of CompareItem) */
+struct WorstOnTop {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority < b.priority;
+    }
+};
+
+/* alignas keeps per-thread partials on separate cache lines */
+class alignas(64) TopK {
+    size_t capacity;
+    vector<Item> heap;          // max-heap on priority value
+    int threshold = INT_MAX;    // priority of the worst kept Item; only meaningful once full
+
+public:
+    explicit TopK(size_t k) : capacity(k) {
+        if (k == 0) throw invalid_argument("TopK: k must be at least 1");
+        heap.reserve(k);
+    }
+
+    size_t size() const { return heap.size(); }
+
+    /* Returns true if the Item was kept. Takes a reference so rejects cost no copy. */
+    bool offer(int priority, const string& description) {
+        if (heap.size() < capacity) {
+            heap.emplace_back(priority, description);
+            push_heap(heap.begin(), heap.end(), WorstOnTop());
+            if (heap.size() == capacity) threshold = heap.front().priority;
+            return true;
+        }
+        if (priority >= threshold) return false; // the common case once warmed up
+        pop_heap(heap.begin(), heap.end(), WorstOnTop());
+        heap.back().priority = priority;
+        heap.back().description.assign(description); // reuses the evicted string's buffer
+        push_heap(heap.begin(), heap.end(), WorstOnTop());
+        threshold = heap.front().priority;
+        return true;
+    }
+
+    bool offer(const Item& item) { return offer(item.priority, item.description); }
+
+    /* Fold another partial result into this one */
+    void merge(const TopK& other) {
+        for (const Item& item : other.heap) offer(item);
+    }
+
+    /* Kept Items, most important first */
+    vector<Item> sorted() const {
+        vector<Item> out = heap;
+        sort(out.begin(), out.end(), [](const Item& a, const Item& b) { return a.priority < b.priority; });
+        return out;
+    }
+};
+
+/* A reproducible synthetic stream: priority of the i-th Item */
+static int streamPriority(uint64_t i) {
+    uint64_t x = i * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 29;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 32;
+    return static_cast<int>(x & 0x7FFFFFFF);
+}
+
+static const string streamDescription = "sensor reading from the ingest pipeline";
+
+/* DEMO */
+void basicDemo() {
+    TopK top(2);
+    top.offer(Item(3, "Whey Protein"));
+    top.offer(Item(1, "Eggs"));
+    top.offer(Item(5, "Dumbbells"));
+    top.offer(Item(2, "Cables"));
+
+    cout << "Top 2 items:\n";
+    for (const Item& i : top.sorted())
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+
+    TopK edge(2);
+    edge.offer(Item(INT_MAX, "Someday"));
+    cout << "INT_MAX priority kept while not full: " << (edge.size() == 1 ? "yes" : "NO") << "\n";
+    try {
+        TopK none(0);
+    } catch (const invalid_argument& e) {
+        cout << "TopK(0): " << e.what() << "\n";
+    }
+}
+
+/* BENCHMARK */
+TopK parallelTopK(size_t k, uint64_t n, int threads) {
+    vector<TopK> partials(threads, TopK(k));
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            uint64_t begin = n * t / threads, end = n * (t + 1) / threads;
+            for (uint64_t i = begin; i < end; i++) partials[t].offer(streamPriority(i), streamDescription);
+        });
+    }
+    for (auto& th : pool) th.join();
+    for (int t = 1; t < threads; t++) partials[0].merge(partials[t]);
+    return partials[0];
+}
+
+void benchmark(size_t k, uint64_t n) {
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+
+    // Baseline: keep everything, then pop K. Capped so it fits in memory.
+    uint64_t baselineN = min<uint64_t>(n, 10000000);
+    long long c1 = 0;
+    auto t0 = Clock::now();
+    {
+        priority_queue<Item, vector<Item>, CompareItem> all;
+        for (uint64_t i = 0; i < baselineN; i++) all.push(Item(streamPriority(i), streamDescription));
+        for (size_t i = 0; i < k && !all.empty(); i++) {
+            c1 += all.top().priority;
+            all.pop();
+        }
+    }
+    auto t1 = Clock::now();
+    long long c2 = 0;
+    for (const Item& i : parallelTopK(k, baselineN, 1).sorted()) c2 += i.priority;
+
+    cout << "\nBenchmark (K = " << k << "):\n"
+         << "  priority_queue, keep all " << baselineN << ": " << ms(t1 - t0) << " ms\n"
+         << "  (same " << baselineN << " items through TopK agree: " << (c1 == c2 ? "yes" : "NO") << ")\n";
+
+    long long reference = 0;
+    for (int threads : {1, 2, 4, 8}) {
+        auto t2 = Clock::now();
+        TopK result = parallelTopK(k, n, threads);
+        auto t3 = Clock::now();
+        long long sum = 0;
+        for (const Item& i : result.sorted()) sum += i.priority;
+        if (threads == 1) reference = sum;
+        double seconds = chrono::duration<double>(t3 - t2).count();
+        cout << "  TopK over " << n << " items, " << threads << " thread(s): " << ms(t3 - t2) << " ms ("
+             << n / seconds / 1e6 << " M items/s)" << (sum == reference ? "" : "  MISMATCH") << "\n";
+    }
+}
+
+int main() {
+    basicDemo();
+    benchmark(100, 200000000);
+    return 0;
+}
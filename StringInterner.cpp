@@ -0,0 +1,323 @@
+/*
+=================================== STRING INTERNING ====================================
+
+Programs often store the same few thousand strings millions of times: the keys of
+map<string, int> in STL-containers.cpp, Item::description in the priority queue
+examples, field names, tags, user names...
+
+Every copy of a long std::string is a separate heap allocation, and every comparison
+or hash has to walk the characters.
+
+Interning: keep exactly ONE copy of each distinct string, and hand out a Symbol, a
+32-bit number, instead.
+  - Same text  <=>  same Symbol. Comparing and hashing Symbols is integer work.
+  - A Symbol takes 4 bytes instead of 32 (sizeof(std::string)) plus the heap copy.
+  - Symbols are dense (0, 1, 2, ...), so per-string data can live in a plain vector
+    indexed by the Symbol instead of a map.
+
+StringInterner
+  - The characters live in an ARENA: large blocks that are filled one string after
+    another and never moved or freed, so view(symbol) returns a string_view that
+    stays valid as long as the interner exists.
+  - The string -> Symbol index is split into SHARDS, each with its own lock and its
+    own open-addressing table, chosen by the string's hash. Threads interning
+    different strings rarely touch the same shard. Looking up a string that is
+    already interned (the common case) takes only a shared (reader) lock.
+  - Symbol -> text is a two-level table (fixed blocks of string_views that never move),
+    so view() needs no lock at all.
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+using namespace std;
+
+struct Symbol {
+    uint32_t id;
+
+    bool operator==(Symbol o) const { return id == o.id; }
+    bool operator!=(Symbol o) const { return id != o.id; }
+    bool operator<(Symbol o) const { return id < o.id; } // order of interning, not alphabetical
+};
+
+namespace std {
+template <>
+struct hash<Symbol> {
+    size_t operator()(Symbol s) const { return s.id * 0x9E3779B97F4A7C15ull; }
+};
+}
+
+class StringInterner {
+    static constexpr size_t SHARDS = 16;
+    static constexpr size_t ARENA_BLOCK = 64 * 1024;
+    static constexpr size_t VIEW_BLOCK = 1 << 16;     // string_views per block of the id table
+    static constexpr size_t MAX_VIEW_BLOCKS = 1 << 16; // 2^32 symbols in total
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Slot {
+        uint64_t hash;
+        uint32_t id = EMPTY;
+    };
+
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        vector<Slot> slots = vector<Slot>(64);
+        size_t count = 0;
+        vector<unique_ptr<char[]>> arena;
+        size_t arenaUsed = 0; // bytes used in arena.back()
+        size_t arenaBytes = 0;
+    };
+
+    Shard shards[SHARDS];
+    unique_ptr<atomic<string_view*>[]> views; // id -> text, allocated in blocks
+    mutex viewBlockLock;
+    atomic<uint32_t> nextId{0};
+
+    /* Copies the text into the shard's arena (caller holds the shard's exclusive lock) */
+    static string_view store(Shard& sh, string_view s) {
+        if (sh.arena.empty() || sh.arenaUsed + s.size() > ARENA_BLOCK) {
+            size_t blockSize = max(ARENA_BLOCK, s.size()); // oversized strings get a block of their own
+            sh.arena.push_back(make_unique<char[]>(blockSize));
+            sh.arenaBytes += blockSize;
+            sh.arenaUsed = blockSize == ARENA_BLOCK ? 0 : blockSize;
+            if (blockSize != ARENA_BLOCK) {
+                memcpy(sh.arena.back().get(), s.data(), s.size());
+                return string_view(sh.arena.back().get(), s.size());
+            }
+        }
+        char* dst = sh.arena.back().get() + sh.arenaUsed;
+        memcpy(dst, s.data(), s.size());
+        sh.arenaUsed += s.size();
+        return string_view(dst, s.size());
+    }
+
+    string_view* viewSlot(uint32_t id) {
+        atomic<string_view*>& block = views[id / VIEW_BLOCK];
+        string_view* b = block.load(memory_order_acquire);
+        if (!b) {
+            lock_guard<mutex> guard(viewBlockLock);
+            b = block.load(memory_order_relaxed);
+            if (!b) {
+                b = new string_view[VIEW_BLOCK];
+                block.store(b, memory_order_release);
+            }
+        }
+        return b + id % VIEW_BLOCK;
+    }
+
+    /* Slot index holding s, or the empty slot where it would go */
+    size_t probe(const Shard& sh, uint64_t h, string_view s) const {
+        size_t mask = sh.slots.size() - 1;
+        for (size_t i = (h >> 4) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = sh.slots[i];
+            if (slot.id == EMPTY || (slot.hash == h && view(Symbol{slot.id}) == s)) return i;
+        }
+    }
+
+    static void grow(Shard& sh) {
+        vector<Slot> old = move(sh.slots);
+        sh.slots.assign(old.size() * 2, Slot{});
+        size_t mask = sh.slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.id == EMPTY) continue;
+            size_t i = (slot.hash >> 4) & mask;
+            while (sh.slots[i].id != EMPTY) i = (i + 1) & mask;
+            sh.slots[i] = slot;
+        }
+    }
+
+public:
+    StringInterner() : views(new atomic<string_view*>[MAX_VIEW_BLOCKS]) {
+        for (size_t i = 0; i < MAX_VIEW_BLOCKS; i++) views[i].store(nullptr, memory_order_relaxed);
+    }
+    ~StringInterner() {
+        for (size_t i = 0; i < MAX_VIEW_BLOCKS; i++) delete[] views[i].load(memory_order_relaxed);
+    }
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    Symbol intern(string_view s) {
+        uint64_t h = hash<string_view>()(s);
+        Shard& sh = shards[h % SHARDS];
+        {
+            shared_lock<shared_mutex> guard(sh.lock);
+            const Slot& slot = sh.slots[probe(sh, h, s)];
+            if (slot.id != EMPTY) return Symbol{slot.id};
+        }
+        unique_lock<shared_mutex> guard(sh.lock);
+        size_t i = probe(sh, h, s); // another thread may have added it meanwhile
+        if (sh.slots[i].id != EMPTY) return Symbol{sh.slots[i].id};
+
+        uint32_t id = nextId.fetch_add(1, memory_order_relaxed);
+        if (id == EMPTY) throw length_error("StringInterner: out of 32-bit symbols");
+        *viewSlot(id) = store(sh, s);
+        sh.slots[i] = Slot{h, id};
+        if (++sh.count * 10 > sh.slots.size() * 7) grow(sh);
+        return Symbol{id};
+    }
+
+    /* The Symbol for s if it was interned before; does not add anything */
+    bool find(string_view s, Symbol& out) const {
+        uint64_t h = hash<string_view>()(s);
+        const Shard& sh = shards[h % SHARDS];
+        shared_lock<shared_mutex> guard(sh.lock);
+        const Slot& slot = sh.slots[probe(sh, h, s)];
+        if (slot.id == EMPTY) return false;
+        out = Symbol{slot.id};
+        return true;
+    }
+
+    /* Text of a Symbol returned by this interner; valid for the interner's lifetime */
+    string_view view(Symbol s) const { return views[s.id / VIEW_BLOCK].load(memory_order_acquire)[s.id % VIEW_BLOCK]; }
+
+    size_t size() const { return nextId.load(); }
+
+    size_t memoryBytes() const {
+        size_t total = 0;
+        for (const Shard& sh : shards) {
+            shared_lock<shared_mutex> guard(sh.lock);
+            total += sh.arenaBytes + sh.slots.size() * sizeof(Slot);
+        }
+        return total + (size() + VIEW_BLOCK - 1) / VIEW_BLOCK * VIEW_BLOCK * sizeof(string_view);
+    }
+};
+
+/* DEMO: Item::description and map<string, int> with Symbols */
+class Item {
+public:
+    int priority;
+    Symbol description;
+    Item(int p, Symbol d) : priority(p), description(d) {}
+};
+
+void demo() {
+    StringInterner pool;
+    vector<Item> items;
+    for (int i = 0; i < 6; i++) items.emplace_back(i, pool.intern(i % 2 ? "Write code" : "Fix bugs"));
+    cout << "6 items, " << pool.size() << " distinct descriptions; item 3: " << pool.view(items[3].description)
+         << " (same Symbol as item 1: " << (items[3].description == items[1].description) << ")\n";
+
+    unordered_map<Symbol, int> ages;
+    ages[pool.intern("Alice")] = 30;
+    ages[pool.intern("Bob")] = 25;
+    Symbol alice;
+    if (pool.find("Alice", alice)) cout << pool.view(alice) << " -> " << ages[alice] << "\n";
+    Symbol nobody;
+    cout << "find(\"Carol\"): " << (pool.find("Carol", nobody) ? "found" : "not interned") << "\n";
+}
+
+/* SELF-TEST: round trips, including the empty string as the very first entry */
+bool selfTest() {
+    StringInterner pool;
+    size_t failures = 0;
+    Symbol empty = pool.intern("");
+    if (pool.view(empty) != "" || !(pool.intern("") == empty)) failures++;
+    vector<string> words = {"a", "", "alpha", string(100000, 'x'), "beta", "a"};
+    vector<Symbol> symbols;
+    for (const string& w : words) symbols.push_back(pool.intern(w));
+    for (size_t i = 0; i < words.size(); i++) {
+        Symbol found;
+        if (pool.view(symbols[i]) != words[i] || !pool.find(words[i], found) || !(found == symbols[i])) failures++;
+    }
+    if (pool.size() != 5) failures++;
+    cout << "Self-test: " << failures << " failures\n";
+    return failures == 0;
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    // 5000 distinct keys, longer than the small-string buffer, repeated 5 million times
+    mt19937 rng(46);
+    vector<string> keys;
+    for (int i = 0; i < 5000; i++) keys.push_back("service/region-" + to_string(i % 17) + "/endpoint-" + to_string(i));
+    const size_t n = 5000000;
+    vector<uint32_t> picks(n);
+    for (auto& p : picks) p = rng() % keys.size();
+
+    vector<string> asStrings;
+    asStrings.reserve(n);
+    size_t stringBytes = n * sizeof(string);
+    double tStrings = timeMs([&] {
+        for (uint32_t p : picks) asStrings.push_back(keys[p]);
+    });
+    for (const string& s : asStrings) stringBytes += s.capacity() + 1;
+
+    StringInterner pool;
+    vector<Symbol> asSymbols;
+    asSymbols.reserve(n);
+    double tSymbols = timeMs([&] {
+        for (uint32_t p : picks) asSymbols.push_back(pool.intern(keys[p]));
+    });
+    size_t symbolBytes = n * sizeof(Symbol) + pool.memoryBytes();
+
+    // Counting occurrences: map<string,int> vs a vector indexed by Symbol
+    map<string, int> countByString;
+    double tMap = timeMs([&] {
+        for (const string& s : asStrings) countByString[s]++;
+    });
+    vector<int> countBySymbol(pool.size());
+    double tVec = timeMs([&] {
+        for (Symbol s : asSymbols) countBySymbol[s.id]++;
+    });
+    bool same = countByString[keys[42]] == countBySymbol[pool.intern(keys[42]).id];
+
+    cout << "\nBenchmark: " << n << " strings, " << pool.size() << " distinct\n"
+         << "  vector<string>: " << tStrings << " ms to fill, " << stringBytes / (1 << 20) << " MB\n"
+         << "  vector<Symbol>: " << tSymbols << " ms to fill (interning), " << symbolBytes / (1 << 20)
+         << " MB including the interner\n"
+         << "  counting: map<string,int> " << tMap << " ms, vector<int>[symbol] " << tVec << " ms"
+         << (same ? "" : " (MISMATCH)") << "\n";
+
+    // Concurrent interning: 4 threads, mostly hits, some new strings
+    const int threads = 4;
+    StringInterner shared;
+    vector<thread> workers;
+    atomic<size_t> checksum{0};
+    double tThreads = timeMs([&] {
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                size_t local = 0;
+                for (size_t i = t; i < n; i += threads) local += shared.intern(keys[picks[i]]).id;
+                checksum += local;
+            });
+        }
+        for (auto& w : workers) w.join();
+    });
+    bool consistent = shared.size() == pool.size();
+    for (const string& k : keys) consistent = consistent && shared.view(shared.intern(k)) == k;
+    cout << "  " << threads << " threads interning " << n << " strings: " << tThreads << " ms ("
+         << (consistent ? "consistent" : "INCONSISTENT") << ")\n";
+}
+
+int main() {
+    demo();
+    if (!selfTest()) return 1;
+    benchmark();
+    return 0;
+}
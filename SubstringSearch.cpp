@@ -0,0 +1,263 @@
+/*
+=================================== SUBSTRING SEARCH ====================================
+
+Faster versions of the "Finding a substring" example in Strings.cpp:
+
+    size_t found = str1.find("World");
+
+Single needle: fastFind(haystack, needle, from)
+  - 1 byte:         memchr (the C library already uses SIMD for it).
+  - up to 32 bytes: SIMD first/last-byte filter. Load 16 haystack positions at once
+                    and compare them with the needle's FIRST byte, and the 16
+                    positions n-1 further on with its LAST byte. Only positions where
+                    both match (usually none) are checked with memcmp. Searching for
+                    "ERROR" in a log rejects 16 positions with a handful of
+                    instructions, where a byte loop would stop at every 'E'.
+  - longer needles: Boyer-Moore-Horspool. Look at the haystack byte under the END of
+                    the needle; if that byte does not occur in the needle we can jump
+                    a whole needle length ahead. The longer the needle, the fewer
+                    bytes are ever read.
+
+Many needles at once: MultiSearcher (Aho-Corasick)
+  - All needles go into one trie; "failure links" say where to continue when the
+    next byte does not extend the current match. Compiled into a DFA table, the
+    text is scanned ONCE, one table lookup per byte, however many needles there are.
+    Filtering a log against 100 keywords with find() reads the log 100 times.
+  - Bytes that occur in no needle all share one column of the table ("byte classes"),
+    which keeps the table small and cache friendly.
+  - Reports every match (overlapping ones too) as (needle index, position).
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+/* SINGLE NEEDLE */
+
+constexpr size_t SHORT_NEEDLE = 32;
+
+static size_t horspool(string_view hay, string_view needle, size_t from) {
+    size_t n = needle.size();
+    array<size_t, 256> shift;
+    shift.fill(n);
+    for (size_t i = 0; i + 1 < n; i++) shift[static_cast<unsigned char>(needle[i])] = n - 1 - i;
+
+    const char last = needle[n - 1];
+    for (size_t pos = from; pos + n <= hay.size();) {
+        char c = hay[pos + n - 1];
+        if (c == last && memcmp(hay.data() + pos, needle.data(), n - 1) == 0) return pos;
+        pos += shift[static_cast<unsigned char>(c)];
+    }
+    return string_view::npos;
+}
+
+static size_t firstLastFilter(string_view hay, string_view needle, size_t from) {
+    size_t n = needle.size();
+    const char* h = hay.data();
+    size_t pos = from;
+    size_t lastStart = hay.size() - n; // last position where the needle can start
+#ifdef __SSE2__
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[n - 1]);
+    for (; pos + 16 <= lastStart + 1; pos += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + pos));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + pos + n - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first),
+                                                                             _mm_cmpeq_epi8(b, last))));
+        while (mask) {
+            size_t cand = pos + __builtin_ctz(mask);
+            if (memcmp(h + cand + 1, needle.data() + 1, n - 2) == 0) return cand;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; pos <= lastStart; pos++)
+        if (h[pos] == needle[0] && h[pos + n - 1] == needle[n - 1] && memcmp(h + pos, needle.data(), n) == 0)
+            return pos;
+    return string_view::npos;
+}
+
+/* Same contract as std::string::find(needle, from) */
+size_t fastFind(string_view hay, string_view needle, size_t from = 0) {
+    if (needle.size() > hay.size() || from > hay.size() - needle.size()) return string_view::npos;
+    if (needle.empty()) return from;
+    if (needle.size() == 1) {
+        const void* hit = memchr(hay.data() + from, needle[0], hay.size() - from);
+        return hit ? static_cast<size_t>(static_cast<const char*>(hit) - hay.data()) : string_view::npos;
+    }
+    if (needle.size() <= SHORT_NEEDLE) return firstLastFilter(hay, needle, from);
+    return horspool(hay, needle, from);
+}
+
+/* MULTIPLE NEEDLES: Aho-Corasick */
+class MultiSearcher {
+    array<uint16_t, 256> byteClass{}; // 0 = byte occurs in no needle (up to 256 others)
+    int classes = 1;
+    vector<int32_t> next;            // DFA: next[state * classes + class]
+    vector<int32_t> output;          // needle ending at this state, or -1
+    vector<int32_t> outputLink;      // next state on the failure chain that has an output, or -1
+    vector<uint32_t> lengths;
+
+public:
+    explicit MultiSearcher(const vector<string>& needles) {
+        for (const string& s : needles)
+            for (unsigned char c : s)
+                if (!byteClass[c]) byteClass[c] = static_cast<uint16_t>(classes++);
+
+        // 1. Trie (-1 = no edge yet)
+        next.assign(classes, -1);
+        output.push_back(-1);
+        for (size_t id = 0; id < needles.size(); id++) {
+            int state = 0;
+            for (unsigned char c : needles[id]) {
+                int32_t& edge = next[state * classes + byteClass[c]];
+                if (edge < 0) {
+                    edge = static_cast<int32_t>(output.size());
+                    output.push_back(-1);
+                    next.resize(next.size() + classes, -1);
+                }
+                state = next[state * classes + byteClass[c]]; // re-read: resize may have moved 'edge'
+            }
+            output[state] = static_cast<int32_t>(id); // duplicate needles: the last one wins
+            lengths.push_back(static_cast<uint32_t>(needles[id].size()));
+        }
+
+        // 2. Failure links in breadth-first order, turning the trie into a complete DFA
+        size_t states = output.size();
+        vector<int32_t> fail(states, 0);
+        outputLink.assign(states, -1);
+        vector<int32_t> queue;
+        for (int c = 0; c < classes; c++) {
+            int32_t& t = next[c];
+            if (t < 0) t = 0;
+            else queue.push_back(t);
+        }
+        for (size_t qi = 0; qi < queue.size(); qi++) {
+            int32_t s = queue[qi];
+            for (int c = 0; c < classes; c++) {
+                int32_t t = next[s * classes + c];
+                if (t < 0) {
+                    next[s * classes + c] = next[fail[s] * classes + c];
+                } else {
+                    fail[t] = next[fail[s] * classes + c];
+                    outputLink[t] = output[fail[t]] >= 0 ? fail[t] : outputLink[fail[t]];
+                    queue.push_back(t);
+                }
+            }
+        }
+    }
+
+    /* Calls onMatch(needleIndex, startPosition) for every occurrence of every needle */
+    template <class F>
+    void findAll(string_view text, F&& onMatch) const {
+        int32_t state = 0;
+        const int32_t* table = next.data();
+        for (size_t i = 0; i < text.size(); i++) {
+            state = table[state * classes + byteClass[static_cast<unsigned char>(text[i])]];
+            for (int32_t s = output[state] >= 0 ? state : outputLink[state]; s >= 0; s = outputLink[s])
+                onMatch(static_cast<size_t>(output[s]), i + 1 - lengths[output[s]]);
+        }
+    }
+
+    size_t states() const { return output.size(); }
+};
+
+/* DEMO */
+void findDemo() {
+    string str1 = "Hello, World!";
+    size_t found = fastFind(str1, "World");
+    if (found != string::npos) cout << "Found 'World' at index: " << found << endl;
+
+    string log = "ERROR: disk full; warning: retry; ERROR: timeout";
+    MultiSearcher ms({"ERROR", "warning", "timeout", "disk"});
+    vector<string> names = {"ERROR", "warning", "timeout", "disk"};
+    ms.findAll(log, [&](size_t id, size_t pos) { cout << "  " << names[id] << " at " << pos << "\n"; });
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+string makeLog(size_t bytes, mt19937& rng) {
+    const vector<string> words = {"INFO",    "DEBUG", "user",    "session", "request", "Error", "handled",
+                                  "latency", "ms",    "cache",   "miss",    "hit",     "Event", "queue",
+                                  "worker",  "done",  "started", "retry",   "EOF",     "Exit"};
+    string log;
+    log.reserve(bytes + 256);
+    while (log.size() < bytes) {
+        log += to_string(rng() % 100000);
+        for (int w = 0; w < 8; w++) {
+            log += ' ';
+            log += words[rng() % words.size()];
+        }
+        if (rng() % 200 == 0) log += " ERROR connection refused by upstream host while sending the request body";
+        log += '\n';
+    }
+    return log;
+}
+
+template <class Find>
+size_t countAll(const string& hay, const string& needle, Find find) {
+    size_t count = 0;
+    for (size_t pos = find(hay, needle, 0); pos != string::npos; pos = find(hay, needle, pos + 1)) count++;
+    return count;
+}
+
+void benchmark() {
+    mt19937 rng(45);
+    string log = makeLog(64u << 20, rng);
+
+    auto stdFind = [](const string& h, const string& n, size_t from) { return h.find(n, from); };
+    auto ourFind = [](const string& h, const string& n, size_t from) { return fastFind(h, n, from); };
+
+    cout << "\nBenchmark on a " << log.size() / (1 << 20) << " MB log:\n";
+    for (string needle : {string("ERROR"), string("connection refused"),
+                          string("refused by upstream host while sending the request body")}) {
+        size_t c1 = 0, c2 = 0;
+        double t1 = timeMs([&] { c1 = countAll(log, needle, stdFind); });
+        double t2 = timeMs([&] { c2 = countAll(log, needle, ourFind); });
+        cout << "  \"" << needle.substr(0, 20) << (needle.size() > 20 ? "...\"" : "\"") << " (" << needle.size()
+             << " bytes): string::find " << t1 << " ms, fastFind " << t2 << " ms (" << c2 << " hits"
+             << (c1 == c2 ? "" : ", MISMATCH") << ")\n";
+    }
+
+    // 100 keywords: one Aho-Corasick pass vs one find() pass per keyword
+    vector<string> keywords = {"ERROR", "refused", "timeout", "panic", "Exit", "EOF"};
+    while (keywords.size() < 100) {
+        string w;
+        for (int i = 0; i < 6; i++) w += static_cast<char>('a' + rng() % 26);
+        keywords.push_back(w);
+    }
+    size_t c1 = 0, c2 = 0;
+    double t1 = timeMs([&] {
+        for (const string& k : keywords) c1 += countAll(log, k, stdFind);
+    });
+    MultiSearcher ms(keywords);
+    double t2 = timeMs([&] { ms.findAll(log, [&](size_t, size_t) { c2++; }); });
+    cout << "  100 keywords: string::find x100 " << t1 << " ms, Aho-Corasick one pass " << t2 << " ms (" << c2
+         << " hits, " << ms.states() << " states" << (c1 == c2 ? "" : ", MISMATCH") << ")\n";
+}
+
+int main() {
+    findDemo();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,334 @@
+/*
+================================= HIERARCHICAL TIMING WHEEL =============================
+
+Scheduling deadlines with the Item model.
+
+In CustomComparatorForPriorityQueue.cpp an Item's priority can be read as "expiry tick",
+and the CompareItem min-heap hands back the earliest deadline first. That is O(log n)
+per insert and pop, and cancelling a timer means lazy deletion or an O(n) search.
+
+A hierarchical timing wheel (Varghese & Lauck) gets:
+  - schedule: O(1)
+  - cancel:   O(1)   (every timer sits in an intrusive doubly-linked list)
+  - advance:  amortized O(1) per tick and per timer
+
+Layout (like a clock with 4 hands, 256 positions each, covering 32-bit ticks):
+  level 0 : slot = expiry bits 0..7    (the next 256 ticks, exact)
+  level 1 : slot = expiry bits 8..15
+  level 2 : slot = expiry bits 16..23
+  level 3 : slot = expiry bits 24..31
+  A timer goes to the level of the highest bit in which its expiry differs from "now".
+  When the lower 8*L bits of now roll over to zero, the matching level-L slot is
+  "cascaded": its timers are re-inserted and fall into lower levels. Each timer can
+  cascade at most 3 times.
+
+Drain semantics match the heap: advance(t, f) calls f for every timer with
+expiry <= t, lowest expiry first (timers sharing a tick come out in any order).
+A 256-bit occupancy map per level lets advance skip runs of empty ticks.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+class Item {
+public:
+    int priority;
+    string description;
+
+    Item(int p, string d) : priority(p), description(move(d)) {}
+};
+
+struct CompareItem {
+    bool operator()(const Item& a, const Item& b) const {
+        return a.priority > b.priority; // Min-heap
+    }
+};
+
+/* Handle returned by schedule(); the generation makes stale handles harmless */
+struct TimerId {
+    uint32_t index;
+    uint32_t generation;
+};
+
+class TimingWheel {
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOTS = 256;
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr int16_t IDLE = -1;   // not in the wheel (free or fired)
+    static constexpr int16_t FIRING = -2; // taken out of its slot, callback not run yet
+
+    struct Node {
+        Item item;
+        uint32_t prev = NIL, next = NIL;
+        uint32_t generation = 0;
+        int16_t level = IDLE; // or FIRING, or the wheel level
+        uint8_t slot = 0;
+    };
+
+    vector<Node> nodes;           // pool; freed nodes are chained through 'next'
+    uint32_t freeHead = NIL;
+    array<array<uint32_t, SLOTS>, LEVELS> heads;
+    array<array<uint64_t, SLOTS / 64>, LEVELS> occupied{};
+    uint32_t now = 0;             // every timer with expiry < now has fired
+    uint32_t firing = NIL;        // timers of the tick being fired, still waiting for their callback
+    size_t active = 0;
+
+    static int slotOf(uint32_t expiry, int level) { return (expiry >> (8 * level)) & (SLOTS - 1); }
+
+    void link(uint32_t id) {
+        Node& n = nodes[id];
+        uint32_t expiry = static_cast<uint32_t>(n.item.priority);
+        if (expiry < now) expiry = now; // already late: fire on the next tick processed
+        uint32_t diff = expiry ^ now;
+        int level = diff == 0 ? 0 : (31 - __builtin_clz(diff)) / 8;
+        int slot = slotOf(expiry, level);
+
+        n.level = static_cast<int16_t>(level);
+        n.slot = static_cast<uint8_t>(slot);
+        n.prev = NIL;
+        n.next = heads[level][slot];
+        if (n.next != NIL) nodes[n.next].prev = id;
+        heads[level][slot] = id;
+        occupied[level][slot / 64] |= 1ull << (slot % 64);
+    }
+
+    void unlink(uint32_t id) {
+        Node& n = nodes[id];
+        uint32_t& head = n.level == FIRING ? firing : heads[n.level][n.slot];
+        if (n.prev != NIL) nodes[n.prev].next = n.next;
+        else head = n.next;
+        if (n.next != NIL) nodes[n.next].prev = n.prev;
+        if (n.level != FIRING && head == NIL) occupied[n.level][n.slot / 64] &= ~(1ull << (n.slot % 64));
+        n.level = IDLE;
+    }
+
+    void release(uint32_t id) {
+        Node& n = nodes[id];
+        n.generation++;
+        n.item.description.clear();
+        n.next = freeHead;
+        freeHead = id;
+        active--;
+    }
+
+    /* Detach a whole slot list and hand back its first node */
+    uint32_t takeSlot(int level, int slot) {
+        uint32_t id = heads[level][slot];
+        heads[level][slot] = NIL;
+        occupied[level][slot / 64] &= ~(1ull << (slot % 64));
+        return id;
+    }
+
+    void cascade(int level) {
+        uint32_t id = takeSlot(level, slotOf(now, level));
+        while (id != NIL) {
+            uint32_t next = nodes[id].next;
+            link(id);
+            id = next;
+        }
+    }
+
+    /* First occupied level-0 slot at or after 'from' within the current rotation, or SLOTS */
+    int nextOccupied(int from) const {
+        for (int w = from / 64; w < SLOTS / 64; w++) {
+            uint64_t bits = occupied[0][w];
+            if (w == from / 64) bits &= ~0ull << (from % 64);
+            if (bits) return w * 64 + __builtin_ctzll(bits);
+        }
+        return SLOTS;
+    }
+
+public:
+    TimingWheel() {
+        for (auto& level : heads) level.fill(NIL);
+    }
+
+    void reserve(size_t n) { nodes.reserve(n); }
+    size_t size() const { return active; }
+    bool empty() const { return active == 0; }
+    uint32_t currentTick() const { return now; }
+
+    /* item.priority is the expiry tick */
+    TimerId schedule(Item item) {
+        uint32_t id;
+        if (freeHead != NIL) {
+            id = freeHead;
+            freeHead = nodes[id].next;
+            nodes[id].item = move(item);
+        } else {
+            id = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node{move(item)});
+        }
+        link(id);
+        active++;
+        return {id, nodes[id].generation};
+    }
+
+    bool cancel(TimerId t) {
+        if (t.index >= nodes.size()) return false;
+        Node& n = nodes[t.index];
+        if (n.generation != t.generation || n.level == IDLE) return false;
+        unlink(t.index);
+        release(t.index);
+        return true;
+    }
+
+    /* Fire every timer with expiry <= target, in expiry order. Callbacks may schedule and
+       cancel timers, including ones due on the tick being fired. */
+    template <class OnExpire>
+    void advance(uint32_t target, OnExpire onExpire) {
+        const uint32_t stop = target == UINT32_MAX ? target : target + 1; // 'now' after the call
+        while (now <= target) {
+            if (active == 0) {
+                now = stop;
+                break;
+            }
+            // Roll higher hands over first so their timers can land in the slots below
+            for (int level = LEVELS - 1; level > 0; level--)
+                if ((now & ((1u << (8 * level)) - 1)) == 0) cascade(level);
+
+            int slot = nextOccupied(now & (SLOTS - 1));
+            uint32_t rotationEnd = (now | (SLOTS - 1));
+            if (slot == SLOTS) {
+                if (rotationEnd >= target) {
+                    now = stop;
+                    break;
+                }
+                now = rotationEnd + 1; // next cascade boundary
+                continue;
+            }
+            uint32_t tick = (now & ~uint32_t(SLOTS - 1)) | static_cast<uint32_t>(slot);
+            if (tick > target) {
+                now = stop;
+                break;
+            }
+            now = tick;
+
+            // Callbacks may schedule more timers for this same tick, so loop until empty.
+            // The taken list stays reachable through 'firing' so cancel() can still remove
+            // a timer that has not fired yet.
+            while (heads[0][slot] != NIL) {
+                firing = takeSlot(0, slot);
+                for (uint32_t id = firing; id != NIL; id = nodes[id].next) nodes[id].level = FIRING;
+                while (firing != NIL) {
+                    uint32_t id = firing;
+                    unlink(id);
+                    Item item = move(nodes[id].item); // schedule() in the callback may reallocate 'nodes'
+                    release(id);
+                    onExpire(item);
+                }
+            }
+            if (now == UINT32_MAX) break;
+            now++;
+        }
+    }
+};
+
+/* DEMO */
+void basicDemo() {
+    TimingWheel wheel;
+    wheel.schedule(Item(3, "Whey Protein"));
+    wheel.schedule(Item(1, "Eggs"));
+    TimerId dumbbells = wheel.schedule(Item(5, "Dumbbells"));
+    wheel.schedule(Item(2, "Cables"));
+    wheel.schedule(Item(70000, "Deload week")); // lives on level 2 until it cascades down
+
+    wheel.cancel(dumbbells);
+
+    cout << "Timers in order of expiry:\n";
+    wheel.advance(100000, [](const Item& i) {
+        cout << "- " << i.description << " (Priority: " << i.priority << ")\n";
+    });
+}
+
+/* DEMO: callbacks that cancel and schedule timers while the wheel is firing */
+void callbackDemo() {
+    TimingWheel wheel;
+    wheel.schedule(Item(10, "A"));
+    TimerId b = wheel.schedule(Item(10, "B"));
+    wheel.schedule(Item(10, "C"));
+    int fired = 0, rearmed = 0;
+    wheel.advance(10, [&](const Item& i) {
+        fired++;
+        cout << "fire " << i.description;
+        if (i.description == "C") cout << ", cancel B -> " << wheel.cancel(b);
+        // Enough new timers to reallocate the node pool while 'i' is still in use
+        for (int k = 0; k < 1000; k++) wheel.schedule(Item(20 + k, "later"));
+        cout << " (still " << i.description << ")\n";
+    });
+    wheel.advance(UINT32_MAX, [&](const Item&) { rearmed++; });
+    cout << "fired " << fired << " of 3 at tick 10, then " << rearmed << " later timers; size " << wheel.size()
+         << ", tick after advance(UINT32_MAX) = " << wheel.currentTick() << "\n";
+}
+
+/* BENCHMARK: n active timers, all drained, wheel vs CompareItem heap */
+void benchmark(size_t n, uint32_t horizon) {
+    using Clock = chrono::steady_clock;
+    auto ms = [](auto d) { return chrono::duration<double, milli>(d).count(); };
+    long long c1 = 0, c2 = 0;
+
+    vector<int> expiries(n);
+    mt19937 rng(11);
+    uniform_int_distribution<uint32_t> dist(1, horizon);
+    for (auto& e : expiries) e = static_cast<int>(dist(rng));
+
+    double heapInsert, heapDrain;
+    {
+        priority_queue<Item, vector<Item>, CompareItem> heap;
+        auto t0 = Clock::now();
+        for (int e : expiries) heap.push(Item(e, "timer"));
+        auto t1 = Clock::now();
+        while (!heap.empty()) {
+            c1 += heap.top().priority;
+            heap.pop();
+        }
+        auto t2 = Clock::now();
+        heapInsert = ms(t1 - t0);
+        heapDrain = ms(t2 - t1);
+    }
+
+    double wheelInsert, wheelCancel, wheelDrain;
+    {
+        TimingWheel wheel;
+        wheel.reserve(n);
+        vector<TimerId> ids;
+        ids.reserve(n);
+        auto t0 = Clock::now();
+        for (int e : expiries) ids.push_back(wheel.schedule(Item(e, "timer")));
+        auto t1 = Clock::now();
+        // Cancel every 10th timer and re-arm it at the same deadline (a typical "reset")
+        for (size_t i = 0; i < n; i += 10) {
+            wheel.cancel(ids[i]);
+            wheel.schedule(Item(expiries[i], "timer"));
+        }
+        auto t2 = Clock::now();
+        wheel.advance(horizon, [&](const Item& i) { c2 += i.priority; });
+        auto t3 = Clock::now();
+        wheelInsert = ms(t1 - t0);
+        wheelCancel = ms(t2 - t1);
+        wheelDrain = ms(t3 - t2);
+    }
+
+    cout << "\nBenchmark (" << n << " active timers over " << horizon << " ticks):\n"
+         << "  heap:  insert " << heapInsert << " ms, drain " << heapDrain << " ms\n"
+         << "  wheel: insert " << wheelInsert << " ms, drain " << wheelDrain
+         << " ms (plus " << wheelCancel << " ms for " << n / 10 << " cancel+re-arm)\n"
+         << "  checksums match: " << (c1 == c2 ? "yes" : "NO") << endl;
+}
+
+int main() {
+    basicDemo();
+    callbackDemo();
+    benchmark(10000000, 1u << 24);
+    return 0;
+}
@@ -0,0 +1,550 @@
+/*
+=================================== UTF-8 VALIDATION ====================================
+
+std::string in Strings.cpp and StringStreams.cpp is just bytes: nothing stops it from
+holding a byte sequence that is not valid UTF-8. Text from the network or from files
+must be validated before it is trusted.
+
+UTF-8 in one table:
+    U+0000   .. U+007F     0xxxxxxx
+    U+0080   .. U+07FF     110xxxxx 10xxxxxx
+    U+0800   .. U+FFFF     1110xxxx 10xxxxxx 10xxxxxx      (except U+D800..U+DFFF)
+    U+10000  .. U+10FFFF   11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+and every code point must use the SHORTEST form ("overlong" encodings are invalid).
+
+validateUtf8Scalar(): the textbook byte-by-byte decoder. It is the reference.
+
+validateUtf8(): the Keiser-Lemire algorithm (as used in simdjson / simdutf):
+  - 16 bytes at a time. If all are ASCII (high bit clear), skip them in one step.
+  - Otherwise every error shows up in a PAIR of adjacent bytes. Three 16-entry lookup
+    tables (indexed by the high nibble of the previous byte, its low nibble, and the
+    high nibble of the current byte) each return a set of "possible error" bits; the
+    AND of the three is non-zero only where there really is an error. pshufb (SSSE3)
+    performs 16 such table lookups in one instruction.
+  - A 3rd/4th byte that must be a continuation is checked against the bytes 2 and 3
+    positions back.
+  - No branches per byte; errors are OR-ed into one register, checked once at the end.
+  Needs SSSE3 (-mssse3 or -march=native); otherwise only the ASCII skip is SIMD.
+
+Transcoders: utf8ToUtf16, utf8ToUtf32, utf16ToUtf8, utf32ToUtf8
+  - Validate while converting (surrogates, overlong forms, out-of-range values).
+  - Runs of ASCII are converted 16 (or 8, or 4) characters at a time with SSE2.
+  - Return { ok, position }: on error, position is the index of the first bad input unit.
+
+The self-test compares validateUtf8 with the scalar reference on a hand-made corpus of
+edge cases and on a million randomly mutated strings (a small fuzzer), and checks
+round trips through all the transcoders.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+using namespace std;
+
+/* SCALAR DECODING */
+
+/* Length of the valid sequence at p (with 'avail' bytes left), 0 if invalid; sets cp */
+static inline int decodeOne(const unsigned char* p, size_t avail, uint32_t& cp) {
+    unsigned char c = p[0];
+    int len;
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+        cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        cp = c & 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        cp = c & 0x07;
+    } else {
+        return 0; // continuation byte, 0xC0/0xC1 (always overlong) or 0xF5..0xFF
+    }
+    if (avail < static_cast<size_t>(len)) return 0;
+    for (int k = 1; k < len; k++) {
+        if ((p[k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (p[k] & 0x3F);
+    }
+    if (len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) return 0;
+    if (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)) return 0;
+    return len;
+}
+
+static inline int encodeUtf8(uint32_t cp, char* dst) {
+    if (cp < 0x80) {
+        dst[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+        dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+        dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+    dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+bool validateUtf8Scalar(string_view s) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    size_t i = 0, n = s.size();
+    uint32_t cp;
+    while (i < n) {
+        int len = decodeOne(p + i, n - i, cp);
+        if (!len) return false;
+        i += len;
+    }
+    return true;
+}
+
+/* SIMD VALIDATION */
+
+#ifdef __SSSE3__
+namespace keiser_lemire {
+
+// Error bits: each lookup table answers "which errors are still possible?"
+constexpr uint8_t TOO_SHORT = 1 << 0;  // lead byte not followed by a continuation
+constexpr uint8_t TOO_LONG = 1 << 1;   // ASCII followed by a continuation
+constexpr uint8_t OVERLONG_3 = 1 << 2; // E0 80..9F
+constexpr uint8_t TOO_LARGE = 1 << 3;  // F4 90..BF, F5..FF
+constexpr uint8_t SURROGATE = 1 << 4;  // ED A0..BF
+constexpr uint8_t OVERLONG_2 = 1 << 5; // C0, C1
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+constexpr uint8_t OVERLONG_4 = 1 << 6; // F0 80..8F
+constexpr uint8_t TWO_CONTS = 1 << 7;  // continuation after continuation
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+static inline __m128i table(uint8_t a0, uint8_t a1, uint8_t a2, uint8_t a3, uint8_t a4, uint8_t a5, uint8_t a6,
+                            uint8_t a7, uint8_t a8, uint8_t a9, uint8_t a10, uint8_t a11, uint8_t a12, uint8_t a13,
+                            uint8_t a14, uint8_t a15) {
+    return _mm_setr_epi8(static_cast<char>(a0), static_cast<char>(a1), static_cast<char>(a2), static_cast<char>(a3),
+                         static_cast<char>(a4), static_cast<char>(a5), static_cast<char>(a6), static_cast<char>(a7),
+                         static_cast<char>(a8), static_cast<char>(a9), static_cast<char>(a10), static_cast<char>(a11),
+                         static_cast<char>(a12), static_cast<char>(a13), static_cast<char>(a14),
+                         static_cast<char>(a15));
+}
+
+static inline __m128i highNibble(__m128i v) { return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)); }
+
+static inline __m128i specialCases(__m128i input, __m128i prev1) {
+    const __m128i byte1High = table(TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                                    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, TOO_SHORT | OVERLONG_2, TOO_SHORT,
+                                    TOO_SHORT | OVERLONG_3 | SURROGATE,
+                                    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const __m128i byte1Low = table(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+                                   CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                                   CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                                   CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                                   CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                                   CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                                   CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const __m128i byte2High =
+        table(TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+              TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+              TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+              TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+              TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+    __m128i a = _mm_shuffle_epi8(byte1High, highNibble(prev1));
+    __m128i b = _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+    __m128i c = _mm_shuffle_epi8(byte2High, highNibble(input));
+    return _mm_and_si128(_mm_and_si128(a, b), c);
+}
+
+/* Errors in this block, given the previous block (for the bytes that straddle the boundary) */
+static inline __m128i checkBlock(__m128i input, __m128i prev) {
+    __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+    __m128i sc = specialCases(input, prev1);
+    // Bytes 2 or 3 after a 3- or 4-byte lead must be continuations: that is exactly where
+    // TWO_CONTS (bit 7) must be set, so XOR-ing it out leaves zero only if it all matches.
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(must23, sc);
+}
+
+/* Non-zero if the block ends in the middle of a multi-byte sequence */
+static inline __m128i incomplete(__m128i input) {
+    const __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                           static_cast<char>(0xC0 - 1));
+    return _mm_subs_epu8(input, maxValue);
+}
+
+} // namespace keiser_lemire
+#endif
+
+bool validateUtf8(string_view s) {
+    const char* p = s.data();
+    size_t n = s.size(), i = 0;
+#ifdef __SSSE3__
+    using namespace keiser_lemire;
+    __m128i error = _mm_setzero_si128();
+    __m128i prev = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+    auto step = [&](__m128i input) {
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prevIncomplete); // ASCII right after an unfinished sequence
+        } else {
+            error = _mm_or_si128(error, checkBlock(input, prev));
+            prevIncomplete = incomplete(input);
+        }
+        prev = input;
+    };
+    for (; i + 16 <= n; i += 16) step(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    char tail[16] = {0}; // zero padding: an unfinished sequence at the end shows up as TOO_SHORT
+    memcpy(tail, p + i, n - i);
+    step(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)));
+    error = _mm_or_si128(error, prevIncomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#else
+    // No pshufb: skip ASCII 16 bytes at a time, decode the rest one sequence at a time
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    uint32_t cp;
+    while (i < n) {
+#ifdef __SSE2__
+        if (i + 16 <= n && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))) == 0) {
+            i += 16;
+            continue;
+        }
+#endif
+        int len = decodeOne(u + i, n - i, cp);
+        if (!len) return false;
+        i += len;
+    }
+    return true;
+#endif
+}
+
+/* TRANSCODING */
+
+struct TranscodeResult {
+    bool ok = true;
+    size_t position = 0; // index of the first invalid input unit when !ok
+};
+
+TranscodeResult utf8ToUtf32(string_view in, u32string& out) {
+    out.resize(in.size()); // never more code points than bytes
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in.data());
+    char32_t* dst = &out[0];
+    size_t i = 0, n = in.size(), o = 0;
+    while (i < n) {
+#ifdef __SSE2__
+        if (i + 16 <= n) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            if (_mm_movemask_epi8(v) == 0) { // 16 ASCII bytes -> 16 code points
+                __m128i zero = _mm_setzero_si128();
+                __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o + 12), _mm_unpackhi_epi16(hi, zero));
+                i += 16;
+                o += 16;
+                continue;
+            }
+        }
+#endif
+        uint32_t cp;
+        int len = decodeOne(p + i, n - i, cp);
+        if (!len) {
+            out.resize(o);
+            return {false, i};
+        }
+        dst[o++] = cp;
+        i += len;
+    }
+    out.resize(o);
+    return {};
+}
+
+TranscodeResult utf8ToUtf16(string_view in, u16string& out) {
+    out.resize(in.size()); // a 4-byte sequence becomes 2 units, shorter ones 1
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in.data());
+    char16_t* dst = &out[0];
+    size_t i = 0, n = in.size(), o = 0;
+    while (i < n) {
+#ifdef __SSE2__
+        if (i + 16 <= n) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            if (_mm_movemask_epi8(v) == 0) {
+                __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o), _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o + 8), _mm_unpackhi_epi8(v, zero));
+                i += 16;
+                o += 16;
+                continue;
+            }
+        }
+#endif
+        uint32_t cp;
+        int len = decodeOne(p + i, n - i, cp);
+        if (!len) {
+            out.resize(o);
+            return {false, i};
+        }
+        if (cp < 0x10000) {
+            dst[o++] = static_cast<char16_t>(cp);
+        } else {
+            cp -= 0x10000;
+            dst[o++] = static_cast<char16_t>(0xD800 + (cp >> 10));
+            dst[o++] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+        }
+        i += len;
+    }
+    out.resize(o);
+    return {};
+}
+
+TranscodeResult utf16ToUtf8(u16string_view in, string& out) {
+    out.resize(in.size() * 3); // worst case: every unit is a 3-byte BMP character
+    char* dst = &out[0];
+    size_t i = 0, n = in.size(), o = 0;
+    while (i < n) {
+#ifdef __SSE2__
+        if (i + 8 <= n) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i));
+            __m128i high = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) == 0xFFFF) { // 8 ASCII units
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + o), _mm_packus_epi16(v, v));
+                i += 8;
+                o += 8;
+                continue;
+            }
+        }
+#endif
+        uint32_t cp = in[i];
+        size_t units = 1;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            if (i + 1 >= n || in[i + 1] < 0xDC00 || in[i + 1] > 0xDFFF) {
+                out.resize(o);
+                return {false, i};
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (in[i + 1] - 0xDC00);
+            units = 2;
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) { // low surrogate without a high one
+            out.resize(o);
+            return {false, i};
+        }
+        o += encodeUtf8(cp, dst + o);
+        i += units;
+    }
+    out.resize(o);
+    return {};
+}
+
+TranscodeResult utf32ToUtf8(u32string_view in, string& out) {
+    out.resize(in.size() * 4);
+    char* dst = &out[0];
+    size_t i = 0, n = in.size(), o = 0;
+    while (i < n) {
+#ifdef __SSE2__
+        if (i + 4 <= n) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i));
+            __m128i high = _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) == 0xFFFF) { // 4 ASCII units
+                __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+                int four = _mm_cvtsi128_si32(bytes);
+                memcpy(dst + o, &four, 4);
+                i += 4;
+                o += 4;
+                continue;
+            }
+        }
+#endif
+        uint32_t cp = in[i];
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            out.resize(o);
+            return {false, i};
+        }
+        o += encodeUtf8(cp, dst + o);
+        i++;
+    }
+    out.resize(o);
+    return {};
+}
+
+/* SELF-TEST: edge-case corpus + fuzzing against the scalar reference */
+
+string randomValidUtf8(mt19937& rng, size_t codePoints) {
+    string s;
+    char buf[4];
+    for (size_t k = 0; k < codePoints; k++) {
+        uint32_t cp;
+        switch (rng() % 5) {
+            case 0:
+            case 1: cp = rng() % 0x80; break;
+            case 2: cp = 0x80 + rng() % (0x800 - 0x80); break;
+            case 3:
+                cp = 0x800 + rng() % (0x10000 - 0x800 - 0x800);
+                if (cp >= 0xD800) cp += 0x800; // skip the surrogate range
+                break;
+            default: cp = 0x10000 + rng() % (0x110000 - 0x10000);
+        }
+        s.append(buf, encodeUtf8(cp, buf));
+    }
+    return s;
+}
+
+bool selfTest() {
+    struct Case {
+        string bytes;
+        bool valid;
+    };
+    vector<Case> corpus = {
+        {"", true},
+        {"plain ASCII", true},
+        {"\x7F", true},
+        {"\xC2\x80", true},                 // U+0080
+        {"\xDF\xBF", true},                 // U+07FF
+        {"\xE0\xA0\x80", true},             // U+0800
+        {"\xED\x9F\xBF", true},             // U+D7FF
+        {"\xEE\x80\x80", true},             // U+E000
+        {"\xEF\xBF\xBF", true},             // U+FFFF
+        {"\xF0\x90\x80\x80", true},         // U+10000
+        {"\xF4\x8F\xBF\xBF", true},         // U+10FFFF
+        {"\x80", false},                    // lone continuation
+        {"\xC0\x80", false},                // overlong NUL
+        {"\xC1\xBF", false},                // overlong
+        {"\xE0\x9F\xBF", false},            // overlong 3-byte
+        {"\xF0\x8F\xBF\xBF", false},        // overlong 4-byte
+        {"\xED\xA0\x80", false},            // surrogate U+D800
+        {"\xED\xBF\xBF", false},            // surrogate U+DFFF
+        {"\xF4\x90\x80\x80", false},        // U+110000
+        {"\xF5\x80\x80\x80", false},        // lead byte out of range
+        {"\xF8\x88\x80\x80\x80", false},    // 5-byte form
+        {"\xFF", false},
+        {"\xC2", false},                    // truncated at end
+        {"\xE2\x82", false},
+        {"\xF0\x9F\x98", false},
+        {"\xC2\x41", false},                // lead followed by ASCII
+        {"\xE2\x82\xAC\xAC", false},        // one continuation too many
+        {string(15, 'a') + "\xE2\x82\xAC", true},  // sequence across a 16-byte boundary
+        {string(15, 'a') + "\xE2\x82", false},
+        {string(31, 'a') + "\xF0\x9F\x98\x80" + string(20, 'b'), true},
+        {string(16, 'a') + "\xF0\x9F\x98" + string(16, 'b'), false}, // truncated, then a whole ASCII block
+    };
+    int failures = 0;
+    for (const Case& c : corpus) {
+        if (validateUtf8(c.bytes) != c.valid || validateUtf8Scalar(c.bytes) != c.valid) {
+            cout << "  corpus case failed (" << c.bytes.size() << " bytes, expected " << c.valid << ")\n";
+            failures++;
+        }
+    }
+
+    // Fuzz: random valid strings, randomly mutated; SIMD and scalar must always agree
+    mt19937 rng(47);
+    int invalidSeen = 0;
+    for (int t = 0; t < 1000000; t++) {
+        string s = randomValidUtf8(rng, rng() % 40);
+        int mutations = rng() % 3;
+        for (int m = 0; m < mutations && !s.empty(); m++) {
+            size_t pos = rng() % s.size();
+            switch (rng() % 4) {
+                case 0: s[pos] = static_cast<char>(rng()); break;            // random byte
+                case 1: s[pos] ^= static_cast<char>(1 << (rng() % 8)); break; // bit flip
+                case 2: s.erase(pos, 1); break;                               // drop a byte
+                default: s.resize(pos); break;                                // truncate
+            }
+        }
+        bool ref = validateUtf8Scalar(s);
+        invalidSeen += !ref;
+        if (validateUtf8(s) != ref) {
+            if (failures++ < 5) cout << "  fuzz mismatch on a " << s.size() << "-byte input\n";
+        }
+        if (ref && t % 16 == 0) { // round trips through every transcoder
+            u16string u16;
+            u32string u32;
+            string back16, back32;
+            bool ok = utf8ToUtf16(s, u16).ok && utf16ToUtf8(u16, back16).ok && utf8ToUtf32(s, u32).ok &&
+                      utf32ToUtf8(u32, back32).ok;
+            if (!ok || back16 != s || back32 != s) failures++;
+        }
+    }
+    cout << "Self-test: " << corpus.size() << " corpus cases, 1000000 fuzz inputs (" << invalidSeen
+         << " invalid), " << failures << " failures\n";
+    return failures == 0;
+}
+
+/* BENCHMARK */
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark() {
+    mt19937 rng(1);
+    string ascii, mixed;
+    while (ascii.size() < (64u << 20)) ascii += "The quick brown fox jumps over the lazy dog 0123456789.\n";
+    while (mixed.size() < (64u << 20)) {
+        mixed += "English text, then Français, Ελληνικά, 日本語のテキスト and 😀 emoji. ";
+        mixed += randomValidUtf8(rng, 8);
+    }
+
+    for (auto& [name, text] : {pair<const char*, const string&>("ASCII", ascii), {"mixed", mixed}}) {
+        double mb = text.size() / 1e9;
+        bool v1 = false, v2 = false;
+        double tScalar = timeMs([&] { v1 = validateUtf8Scalar(text); });
+        double tSimd = timeMs([&] { v2 = validateUtf8(text); });
+        u16string u16;
+        u32string u32;
+        string back;
+        double t16 = 1e9, t32 = 1e9, tBack = 1e9;
+        for (int rep = 0; rep < 2; rep++) { // the second run reuses the output buffers: no page faults
+            t16 = min(t16, timeMs([&] { utf8ToUtf16(text, u16); }));
+            t32 = min(t32, timeMs([&] { utf8ToUtf32(text, u32); }));
+            tBack = min(tBack, timeMs([&] { utf16ToUtf8(u16, back); }));
+        }
+        cout << "  " << name << " (" << text.size() / (1 << 20) << " MB): validate scalar " << mb / tScalar * 1000
+             << " GB/s, SIMD " << mb / tSimd * 1000 << " GB/s" << (v1 && v2 ? "" : " (INVALID?)") << "\n"
+             << "      utf8->utf16 " << mb / t16 * 1000 << " GB/s, utf8->utf32 " << mb / t32 * 1000
+             << " GB/s, utf16->utf8 " << mb / tBack * 1000 << " GB/s" << (back == text ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+int main() {
+    string text = "Grüße, 世界";
+    u16string u16;
+    utf8ToUtf16(text, u16);
+    cout << "\"" << text << "\": " << text.size() << " bytes, " << u16.size() << " UTF-16 units, valid = "
+         << validateUtf8(text) << "\n";
+    string broken = "abc\xE2\x82";
+    u32string u32;
+    TranscodeResult r = utf8ToUtf32(broken, u32);
+    cout << "truncated input: valid = " << validateUtf8(broken) << ", utf8ToUtf32 fails at byte " << r.position
+         << "\n";
+
+    if (!selfTest()) return 1;
+    cout << "\nBenchmark:\n";
+    benchmark();
+    return 0;
+}
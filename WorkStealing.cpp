@@ -0,0 +1,381 @@
+/*
+================================= WORK-STEALING FORK/JOIN ==============================
+
+A small fork/join runtime for recursive divide-and-conquer code.
+
+The tree recursion of fib() in Recursion.cpp,
+    fib(n) = fib(n-2) + fib(n-1)
+is the classic fork/join shape: the two calls are independent, so they could run on
+different cores. Spawning a std::thread per call would be absurdly expensive, so:
+
+- Workers
+    One worker per thread. The thread that calls ForkJoinPool::run() becomes worker 0.
+
+- Chase-Lev deque per worker (Chase & Lev 2005; memory orders from Le et al. 2013)
+    The owner pushes and pops at the bottom (LIFO, cache-warm, no contention).
+    Idle workers steal from the top (FIFO, i.e. the biggest, oldest subproblems).
+    Only the owner/thief race on the very last element needs a CAS.
+
+- forkJoin(a, b)
+    Push b, run a right here, then pop b back. If b was stolen, do not block: steal
+    and run other work until b is done ("help while waiting").
+
+- Per-worker task arena
+    A forked task is a small closure object. It is bump-allocated in the forking
+    worker's arena and released at the join. Fork/join nesting is strictly LIFO per
+    worker, so the arena is just a pointer that moves up and down. No malloc per fork.
+
+- Sequential cutoff
+    Below a problem size threshold the benchmarks call plain sequential code;
+    forking tiny tasks costs more than it saves.
+
+Benchmarks: parallel fib, parallel mergesort, parallel sum, reporting speedup over the
+sequential version and the number of successful steals.
+
+Compile with -pthread.
+
+==========================================================================================
+*/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <random>
+#include <new>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+/* TASKS */
+struct Task {
+    void (*execute)(Task*);
+    atomic<bool> done{false};
+};
+
+template <class F>
+struct ClosureTask : Task {
+    F f;
+    explicit ClosureTask(F fn) : f(move(fn)) {
+        execute = [](Task* t) { static_cast<ClosureTask*>(t)->f(); };
+    }
+};
+
+/* CHASE-LEV DEQUE (fixed capacity; fork depth is logarithmic or bounded by the cutoff) */
+class WorkDeque {
+    static constexpr int64_t CAPACITY = 1 << 13;
+    alignas(64) atomic<int64_t> top{0};
+    alignas(64) atomic<int64_t> bottom{0};
+    unique_ptr<atomic<Task*>[]> buffer{new atomic<Task*>[CAPACITY]};
+
+public:
+    void push(Task* task) {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_acquire);
+        if (b - t >= CAPACITY) throw overflow_error("WorkDeque full: raise the cutoff");
+        buffer[b & (CAPACITY - 1)].store(task, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+    }
+
+    /* Owner only */
+    Task* pop() {
+        int64_t b = bottom.load(memory_order_relaxed) - 1;
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t t = top.load(memory_order_relaxed);
+        Task* task = nullptr;
+        if (t <= b) {
+            task = buffer[b & (CAPACITY - 1)].load(memory_order_relaxed);
+            if (t == b) { // last element: race against thieves
+                if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+                    task = nullptr;
+                bottom.store(b + 1, memory_order_relaxed);
+            }
+        } else {
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return task;
+    }
+
+    /* Any thread */
+    Task* steal() {
+        int64_t t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t b = bottom.load(memory_order_acquire);
+        if (t >= b) return nullptr;
+        Task* task = buffer[t & (CAPACITY - 1)].load(memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+            return nullptr; // lost the race, caller just tries again
+        return task;
+    }
+};
+
+/* PER-WORKER BUMP ARENA */
+class TaskArena {
+    vector<unsigned char> memory;
+    size_t used = 0;
+
+public:
+    explicit TaskArena(size_t bytes) : memory(bytes) {}
+
+    size_t mark() const { return used; }
+    void release(size_t m) { used = m; }
+
+    void* allocate(size_t size, size_t align) {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if (start + size > memory.size()) throw bad_alloc();
+        used = start + size;
+        return memory.data() + start;
+    }
+};
+
+/* RUNTIME */
+class ForkJoinPool {
+    struct alignas(64) Worker {
+        WorkDeque deque;
+        TaskArena arena{1 << 20};
+        uint64_t rng;
+        atomic<size_t> steals{0};
+        int index = 0;
+        ForkJoinPool* pool = nullptr;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    atomic<bool> stopping{false};
+    atomic<int> activeJobs{0};
+    mutex sleepMutex;
+    condition_variable wake;
+
+    static thread_local Worker* current;
+
+    Task* trySteal(Worker& self) {
+        size_t n = workers.size();
+        if (n < 2) return nullptr;
+        self.rng ^= self.rng << 13;
+        self.rng ^= self.rng >> 7;
+        self.rng ^= self.rng << 17;
+        size_t victim = self.rng % (n - 1);
+        if (victim >= static_cast<size_t>(self.index)) victim++; // never steal from ourselves
+        Task* task = workers[victim]->deque.steal();
+        if (task) self.steals.fetch_add(1, memory_order_relaxed);
+        return task;
+    }
+
+    static void runTask(Task* task) {
+        task->execute(task);
+        task->done.store(true, memory_order_release);
+    }
+
+    void workerLoop(int index) {
+        current = workers[index].get();
+        int idle = 0;
+        while (!stopping.load(memory_order_relaxed)) {
+            if (activeJobs.load(memory_order_acquire) == 0) {
+                unique_lock<mutex> lock(sleepMutex);
+                wake.wait(lock, [&] { return stopping.load() || activeJobs.load() > 0; });
+                continue;
+            }
+            if (Task* task = trySteal(*current)) {
+                runTask(task);
+                idle = 0;
+            } else if (++idle > 64) {
+                this_thread::yield();
+            }
+        }
+        current = nullptr;
+    }
+
+public:
+    explicit ForkJoinPool(int threadCount) {
+        for (int i = 0; i < threadCount; i++) {
+            workers.push_back(make_unique<Worker>());
+            workers[i]->index = i;
+            workers[i]->pool = this;
+            workers[i]->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (int i = 1; i < threadCount; i++) threads.emplace_back(&ForkJoinPool::workerLoop, this, i);
+    }
+
+    ~ForkJoinPool() {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    size_t totalSteals() const {
+        size_t s = 0;
+        for (auto& w : workers) s += w->steals.load();
+        return s;
+    }
+
+    void resetStats() {
+        for (auto& w : workers) w->steals.store(0);
+    }
+
+    /* Run a root job on the calling thread (as worker 0) with the pool helping */
+    template <class F>
+    auto run(F&& job) {
+        struct Guard {
+            ForkJoinPool& pool;
+            ~Guard() {
+                pool.activeJobs--;
+                current = nullptr;
+            }
+        };
+        current = workers[0].get();
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            activeJobs++;
+        }
+        wake.notify_all();
+        Guard guard{*this};
+        return job();
+    }
+
+    /* Run a() and b() potentially in parallel; returns when both are finished */
+    template <class A, class B>
+    static void forkJoin(A&& a, B&& b) {
+        Worker* self = current;
+        if (!self) throw logic_error("forkJoin called outside ForkJoinPool::run");
+
+        size_t mark = self->arena.mark();
+        using Closure = ClosureTask<decay_t<B>>;
+        auto* task = new (self->arena.allocate(sizeof(Closure), alignof(Closure))) Closure(forward<B>(b));
+
+        self->deque.push(task);
+        a();
+        if (self->deque.pop() == task) {
+            runTask(task); // not stolen: run it inline, cheapest path
+        } else {
+            // Stolen. Our deque is empty now, so help others until the thief finishes b.
+            while (!task->done.load(memory_order_acquire)) {
+                if (Task* other = self->pool->trySteal(*self)) runTask(other);
+                else this_thread::yield();
+            }
+        }
+        task->~Closure();
+        self->arena.release(mark);
+    }
+
+};
+
+thread_local ForkJoinPool::Worker* ForkJoinPool::current = nullptr;
+
+/* BENCHMARK KERNELS */
+int fibSequential(int n) {
+    if (n < 2) return 1;
+    return fibSequential(n - 2) + fibSequential(n - 1);
+}
+
+int fibParallel(int n, int cutoff) {
+    if (n < cutoff) return fibSequential(n);
+    int x = 0, y = 0;
+    ForkJoinPool::forkJoin([&] { x = fibParallel(n - 1, cutoff); },
+                           [&] { y = fibParallel(n - 2, cutoff); });
+    return x + y;
+}
+
+void mergeSortParallel(int* data, int* tmp, size_t n, size_t cutoff) {
+    if (n <= cutoff) {
+        sort(data, data + n);
+        return;
+    }
+    size_t half = n / 2;
+    ForkJoinPool::forkJoin([&] { mergeSortParallel(data, tmp, half, cutoff); },
+                           [&] { mergeSortParallel(data + half, tmp + half, n - half, cutoff); });
+    merge(data, data + half, data + half, data + n, tmp);
+    copy(tmp, tmp + n, data);
+}
+
+void mergeSortSequential(int* data, int* tmp, size_t n, size_t cutoff) {
+    if (n <= cutoff) {
+        sort(data, data + n);
+        return;
+    }
+    size_t half = n / 2;
+    mergeSortSequential(data, tmp, half, cutoff);
+    mergeSortSequential(data + half, tmp + half, n - half, cutoff);
+    merge(data, data + half, data + half, data + n, tmp);
+    copy(tmp, tmp + n, data);
+}
+
+long long sumParallel(const int* data, size_t n, size_t cutoff) {
+    if (n <= cutoff) return accumulate(data, data + n, 0LL);
+    long long left = 0, right = 0;
+    size_t half = n / 2;
+    ForkJoinPool::forkJoin([&] { left = sumParallel(data, half, cutoff); },
+                           [&] { right = sumParallel(data + half, n - half, cutoff); });
+    return left + right;
+}
+
+template <class F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+int main() {
+    const int fibN = 36, fibCutoff = 20;
+    const size_t sortN = 10000000, sortCutoff = 16384, sumCutoff = 65536;
+
+    mt19937 rng(1);
+    vector<int> original(sortN);
+    for (int& x : original) x = static_cast<int>(rng() >> 1);
+    vector<int> data(sortN), tmp(sortN);
+
+    int fibExpected = fibSequential(fibN - 4); // warm up caches and clocks before timing
+    double fibSeq = timeMs([&] { fibExpected = fibSequential(fibN); });
+    data = original;
+    double sortSeq = timeMs([&] { mergeSortSequential(data.data(), tmp.data(), sortN, sortCutoff); });
+    vector<int> sortedExpected = data;
+    long long sumExpected = 0;
+    double sumSeq = timeMs([&] { sumExpected = accumulate(original.begin(), original.end(), 0LL); });
+
+    cout << "Sequential: fib(" << fibN << ") " << fibSeq << " ms, mergesort " << sortN << " ints "
+         << sortSeq << " ms, sum " << sumSeq << " ms\n";
+    cout << "hardware threads: " << thread::hardware_concurrency() << "\n\n";
+    cout << "workers | fib speedup (steals) | mergesort speedup (steals) | sum speedup (steals)\n";
+
+    for (int workers : {1, 2, 4, 8}) {
+        ForkJoinPool pool(workers);
+
+        int fibResult = 0;
+        pool.resetStats();
+        double tFib = timeMs([&] { fibResult = pool.run([&] { return fibParallel(fibN, fibCutoff); }); });
+        size_t fibSteals = pool.totalSteals();
+
+        data = original;
+        pool.resetStats();
+        double tSort = timeMs([&] { pool.run([&] { mergeSortParallel(data.data(), tmp.data(), sortN, sortCutoff); }); });
+        size_t sortSteals = pool.totalSteals();
+        bool sortedOk = data == sortedExpected;
+
+        long long sumResult = 0;
+        pool.resetStats();
+        double tSum = timeMs([&] { sumResult = pool.run([&] { return sumParallel(original.data(), sortN, sumCutoff); }); });
+        size_t sumSteals = pool.totalSteals();
+
+        cout << "   " << workers << "    |   " << fibSeq / tFib << "x (" << fibSteals << ")"
+             << "\t|   " << sortSeq / tSort << "x (" << sortSteals << ")"
+             << "\t\t|   " << sumSeq / tSum << "x (" << sumSteals << ")"
+             << ((fibResult == fibExpected && sortedOk && sumResult == sumExpected) ? "" : "  WRONG RESULT")
+             << "\n";
+    }
+    return 0;
+}